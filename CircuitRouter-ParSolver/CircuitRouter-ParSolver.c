@@ -57,12 +57,18 @@
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
+#include "akers.h"
+#include "bitwave.h"
+#include "combiner.h"
 #include "lib/list.h"
 #include "maze.h"
+#include "multiwave.h"
+#include "path.h"
 #include "router.h"
 #include "lib/timer.h"
 #include "lib/types.h"
 #include "lib/vector.h"
+#include "workpool.h"
 
 enum param_types {
     PARAM_BENDCOST   = (unsigned char)'b',
@@ -70,6 +76,14 @@ enum param_types {
     PARAM_YCOST      = (unsigned char)'y',
     PARAM_ZCOST      = (unsigned char)'z',
     PARAM_NUMTAREFAS = (unsigned char)'t',
+    PARAM_EXPANSION  = (unsigned char)'e',
+    PARAM_WINDOW     = (unsigned char)'w',
+    PARAM_TEAM       = (unsigned char)'p',
+    PARAM_PREDECESSOR = (unsigned char)'r',
+    PARAM_MEMORY     = (unsigned char)'m',
+    PARAM_WORKPOOL   = (unsigned char)'q',
+    PARAM_COMMIT     = (unsigned char)'c',
+    PARAM_REPAIR     = (unsigned char)'i',
 };
 
 enum param_defaults {
@@ -78,6 +92,14 @@ enum param_defaults {
     PARAM_DEFAULT_YCOST      = 1,
     PARAM_DEFAULT_ZCOST      = 2,
     PARAM_DEFAULT_NUMTAREFAS = 1,
+    PARAM_DEFAULT_EXPANSION  = ROUTER_EXPANSION_LEE,
+    PARAM_DEFAULT_WINDOW     = -1,
+    PARAM_DEFAULT_TEAM       = 2,
+    PARAM_DEFAULT_PREDECESSOR = 0,
+    PARAM_DEFAULT_MEMORY     = 0,
+    PARAM_DEFAULT_WORKPOOL   = WORKPOOL_DEQUE,
+    PARAM_DEFAULT_COMMIT     = ROUTER_COMMIT_LOCK,
+    PARAM_DEFAULT_REPAIR     = 0,
 };
 
 bool_t global_doPrint = TRUE;
@@ -96,6 +118,18 @@ static void displayUsage (const char* appName){
     printf("    x <UINT>   [x] movement cost    (%i)\n", PARAM_DEFAULT_XCOST);
     printf("    y <UINT>   [y] movement cost    (%i)\n", PARAM_DEFAULT_YCOST);
     printf("    z <UINT>   [z] movement cost    (%i)\n", PARAM_DEFAULT_ZCOST);
+    printf("    t <UINT>   number of [t]asks    (%i)\n", PARAM_DEFAULT_NUMTAREFAS);
+    printf("    e <STR>    [e]xpansion engine   (%s)\n", router_getExpansionName(PARAM_DEFAULT_EXPANSION));
+    puts("               lee, astar, bidir, dial, parallel, bitwave, batch, akers");
+    printf("    w <INT>    search [w]indow margin (%i = whole grid; batch starts at %i)\n", PARAM_DEFAULT_WINDOW, ROUTER_BATCH_MARGIN);
+    printf("    p <UINT>   [p]arallel expansion threads per net (%i)\n", PARAM_DEFAULT_TEAM);
+    printf("    r          [r]ecord predecessors; lee, dial (%s)\n", (PARAM_DEFAULT_PREDECESSOR ? "true" : "false"));
+    printf("    m <UINT>   private grid [m]emory per thread, KiB (%i = unbounded)\n", PARAM_DEFAULT_MEMORY);
+    printf("    q <STR>    work [q]ueue         (%s)\n", workpool_getKindName(PARAM_DEFAULT_WORKPOOL));
+    puts("               fifo, deque, multi");
+    printf("    c <STR>    [c]ommit mode        (%s)\n", router_getCommitName(PARAM_DEFAULT_COMMIT));
+    puts("               lock, cas, stm (make TM=gnu), combine");
+    printf("    i          [i]ncremental repair after lost commits; lee (%s)\n", (PARAM_DEFAULT_REPAIR ? "true" : "false"));
     printf("    h          [h]elp message       (false)\n");
     exit(1);
 }
@@ -111,6 +145,14 @@ static void setDefaultParams (){
     global_params[PARAM_YCOST]       = PARAM_DEFAULT_YCOST;
     global_params[PARAM_ZCOST]       = PARAM_DEFAULT_ZCOST;
     global_params[PARAM_NUMTAREFAS]  = PARAM_DEFAULT_NUMTAREFAS;
+    global_params[PARAM_EXPANSION]   = PARAM_DEFAULT_EXPANSION;
+    global_params[PARAM_WINDOW]      = PARAM_DEFAULT_WINDOW;
+    global_params[PARAM_TEAM]        = PARAM_DEFAULT_TEAM;
+    global_params[PARAM_PREDECESSOR] = PARAM_DEFAULT_PREDECESSOR;
+    global_params[PARAM_MEMORY]      = PARAM_DEFAULT_MEMORY;
+    global_params[PARAM_WORKPOOL]    = PARAM_DEFAULT_WORKPOOL;
+    global_params[PARAM_COMMIT]      = PARAM_DEFAULT_COMMIT;
+    global_params[PARAM_REPAIR]      = PARAM_DEFAULT_REPAIR;
 }
 
 
@@ -127,15 +169,54 @@ static char* parseArgs (long argc, char* const argv[]){
 
     setDefaultParams();
 
-    while ((opt = getopt(argc, argv, "hb:x:y:z:t:")) != -1) {
+    while ((opt = getopt(argc, argv, "hb:x:y:z:t:e:w:p:rm:q:c:i")) != -1) {
         switch (opt) {
             case 'b':
             case 'x':
             case 'y':
             case 't':
             case 'z':
+            case 'w':
+            case 'p':
+            case 'm':
                 global_params[(unsigned char)opt] = atol(optarg);
                 break;
+            case 'r':
+                global_params[PARAM_PREDECESSOR] = 1;
+                break;
+            case 'i':
+                global_params[PARAM_REPAIR] = 1;
+                break;
+            case 'e': {
+                router_expansion_t expansion;
+                if (router_parseExpansion(optarg, &expansion)) {
+                    global_params[PARAM_EXPANSION] = expansion;
+                } else {
+                    fprintf(stderr, "Unknown expansion engine: %s\n", optarg);
+                    opterr++;
+                }
+                break;
+            }
+            case 'q': {
+                workpool_kind_t kind;
+                if (workpool_parseKind(optarg, &kind)) {
+                    global_params[PARAM_WORKPOOL] = kind;
+                } else {
+                    fprintf(stderr, "Unknown work queue: %s\n", optarg);
+                    opterr++;
+                }
+                break;
+            }
+            case 'c': {
+                router_commit_t commit;
+                if (router_parseCommit(optarg, &commit)) {
+                    global_params[PARAM_COMMIT] = commit;
+                } else {
+                    fprintf(stderr, "Unknown commit mode: %s\n", optarg);
+                    opterr++;
+                }
+                break;
+            }
             case '?':
             case 'h':
             default:
@@ -169,8 +250,6 @@ int main(int argc, char** argv){
      * Initialization
      */
 
-    vector_t* threads = vector_alloc(global_params[PARAM_NUMTAREFAS]);
-
     char* filename = parseArgs(argc, (char** const)argv);
     maze_t* mazePtr = maze_alloc();
     assert(mazePtr);
@@ -181,29 +260,93 @@ int main(int argc, char** argv){
                                        global_params[PARAM_ZCOST],
                                        global_params[PARAM_BENDCOST]);
     assert(routerPtr);
+    routerPtr->expansion = (router_expansion_t)global_params[PARAM_EXPANSION];
+    routerPtr->windowMargin = global_params[PARAM_WINDOW];
+    routerPtr->numExpansionThread = ((global_params[PARAM_TEAM] > 1) ? global_params[PARAM_TEAM] : 1);
+    if (routerPtr->expansion == ROUTER_EXPANSION_PARALLEL &&
+        (routerPtr->xCost < 1 || routerPtr->yCost < 1 || routerPtr->zCost < 1))
+    {
+        /* Levels only settle in order when every move costs something */
+        fprintf(stderr, "Parallel expansion needs costs >= 1; using dial\n");
+        routerPtr->expansion = ROUTER_EXPANSION_DIAL;
+    }
+    if (routerPtr->expansion == ROUTER_EXPANSION_BITWAVE &&
+        !bitwave_isSupported(routerPtr->xCost, routerPtr->yCost, routerPtr->zCost))
+    {
+        /* Waves are whole steps: x and y must match and divide z */
+        fprintf(stderr, "Bitwave expansion needs x == y and z a multiple of x; using lee\n");
+        routerPtr->expansion = ROUTER_EXPANSION_LEE;
+    }
+    if (routerPtr->expansion == ROUTER_EXPANSION_BATCH &&
+        !multiwave_isSupported(routerPtr->xCost, routerPtr->yCost, routerPtr->zCost))
+    {
+        fprintf(stderr, "Batch expansion needs x == y and z a multiple of x; using lee\n");
+        routerPtr->expansion = ROUTER_EXPANSION_LEE;
+    }
+    if (routerPtr->expansion == ROUTER_EXPANSION_AKERS &&
+        !akers_isSupported(routerPtr->xCost, routerPtr->yCost, routerPtr->zCost))
+    {
+        /* The 2-bit labels need every step to cost the same */
+        fprintf(stderr, "Akers expansion needs x == y == z; using lee\n");
+        routerPtr->expansion = ROUTER_EXPANSION_LEE;
+    }
+    routerPtr->isPredecessorLabel = (global_params[PARAM_PREDECESSOR] ? TRUE : FALSE);
+    if (routerPtr->isPredecessorLabel && !router_isPredecessorSupported(routerPtr->expansion)) {
+        fprintf(stderr, "Predecessor labels need lee or dial expansion; tracing by distance\n");
+        routerPtr->isPredecessorLabel = FALSE;
+    }
+    routerPtr->commit = (router_commit_t)global_params[PARAM_COMMIT];
+    if (!router_isCommitSupported(routerPtr->commit)) {
+        fprintf(stderr, "%s commits need a build with TM=gnu; using lock\n",
+                router_getCommitName(routerPtr->commit));
+        routerPtr->commit = ROUTER_COMMIT_LOCK;
+    }
+    routerPtr->isRepairing = (global_params[PARAM_REPAIR] ? TRUE : FALSE);
+    if (routerPtr->isRepairing &&
+        (!router_isRepairSupported(routerPtr->expansion) ||
+         routerPtr->xCost <= 0 || routerPtr->yCost <= 0 || routerPtr->zCost <= 0))
+    {
+        /* Zero-cost steps would let cleared labels hold each other up */
+        fprintf(stderr, "Incremental repair needs lee expansion and positive move costs; "
+                "starting over after conflicts\n");
+        routerPtr->isRepairing = FALSE;
+    }
+    routerPtr->maxPrivateByte = ((global_params[PARAM_MEMORY] > 0) ? (global_params[PARAM_MEMORY] * 1024) : 0);
+    if (routerPtr->maxPrivateByte > 0 && !router_isWindowGridSupported(routerPtr->expansion)) {
+        fprintf(stderr, "A memory ceiling needs window-sized private grids, which %s lacks; "
+                "ignoring it\n", router_getExpansionName(routerPtr->expansion));
+        routerPtr->maxPrivateByte = 0;
+    }
     list_t* pathVectorListPtr = list_alloc(NULL);
     assert(pathVectorListPtr);
 
     pthread_mutex_t lock;
     pthread_mutex_init(&lock, NULL);
 
-    router_solve_arg_t routerArg = {routerPtr, mazePtr, pathVectorListPtr, &lock};
+    long numThread = global_params[PARAM_NUMTAREFAS];
+    workpool_t* workpoolPtr = workpool_alloc((workpool_kind_t)global_params[PARAM_WORKPOOL],
+                                             numThread, mazePtr->workQueuePtr);
+    assert(workpoolPtr);
+
+    combiner_t* combinerPtr = combiner_alloc(numThread);
+    assert(combinerPtr);
+
+    router_solve_arg_t routerArg = {routerPtr, mazePtr, pathVectorListPtr, &lock, workpoolPtr, combinerPtr};
     TIMER_T startTime;
     TIMER_READ(startTime);
 
+    pthread_t* threads = (pthread_t*)malloc(numThread * sizeof(pthread_t));
+    assert(threads);
+
     long i;
-    for (i = 0; i < global_params[PARAM_NUMTAREFAS]; i++) {
-      pthread_t thread;
-      pthread_create(&thread, 0, (void*) router_solve, (void *)&routerArg);
-      vector_pushBack(threads, (void*) &thread);
+    for (i = 0; i < numThread; i++) {
+      pthread_create(&threads[i], 0, (void*) router_solve, (void *)&routerArg);
     }
-    //router_solve((void *)&routerArg);
 
-    //THREAD NOT PAUSING WTF???
-    for (i = 0; i < global_params[PARAM_NUMTAREFAS]; i++) {
-      pthread_join(*((pthread_t*)vector_at(threads, i)), NULL);
+    for (i = 0; i < numThread; i++) {
+      pthread_join(threads[i], NULL);
     }
-    vector_free(threads);
+    free(threads);
     pthread_mutex_destroy(&lock);
 
     TIMER_T stopTime;
@@ -223,7 +366,14 @@ int main(int argc, char** argv){
         exit(-1);
     fprintf(file, "Paths routed    = %li\n", numPathRouted);
     fprintf(file, "Elapsed time    = %f seconds\n", TIMER_DIFF_SECONDS(startTime, stopTime));
+    router_printStats(routerPtr, file);
+    if (routerPtr->commit == ROUTER_COMMIT_COMBINE) {
+        combiner_printStats(combinerPtr, file);
+    }
+    workpool_printStats(workpoolPtr, file);
     fclose(file);
+    combiner_free(combinerPtr);
+    workpool_free(workpoolPtr);
 
     /*
      * Check solution and clean up
@@ -243,10 +393,9 @@ int main(int argc, char** argv){
     list_iter_reset(&it, pathVectorListPtr);
     while (list_iter_hasNext(&it, pathVectorListPtr)) {
         vector_t* pathVectorPtr = (vector_t*)list_iter_next(&it, pathVectorListPtr);
-        vector_t* v;
-        while((v = vector_popBack(pathVectorPtr))) {
-            // v stores pointers to longs stored elsewhere; no need to free them here
-            vector_free(v);
+        path_t* p;
+        while((p = vector_popBack(pathVectorPtr))) {
+            path_free(p);
         }
         vector_free(pathVectorPtr);
     }
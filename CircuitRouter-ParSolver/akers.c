@@ -0,0 +1,365 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * akers.c
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "akers.h"
+#include "coordinate.h"
+#include "grid.h"
+#include "occupancy.h"
+#include "path.h"
+#include "lib/types.h"
+
+
+/*
+ * Lee expansion over a private grid of 2 bits per point (Akers' coding).
+ *
+ * With equal costs the grid graph is bipartite, so neighbors are exactly one
+ * step apart. Labeling distance d with the sequence 1, 1, 2, 2, 1, 1, ...
+ * (AKERS_LABEL) then gives the neighbors at d - 1 and d + 1 different
+ * labels, and a traceback that knows the distance of the destination can
+ * always tell which neighbor is one step closer. The remaining two codes
+ * mark free and blocked points. The private grid holds only the window, with
+ * a blocked border so neighbors need no bounds test.
+ */
+
+enum akers_code {
+    AKERS_FREE    = 0,
+    AKERS_BLOCKED = 3,
+};
+
+#define AKERS_LABEL(d)  ((((d) >> 1) & 1) + 1)
+
+enum akers_config {
+    AKERS_LIST_INIT_CAPACITY = 1024,
+};
+
+typedef struct index_list {
+    long* elements;
+    long size;
+    long capacity;
+} index_list_t;
+
+struct akers {
+    uint64_t* words;      /* 32 points per word */
+    long capacity;        /* in words */
+    long padWidth;        /* window width + 2 */
+    long padArea;         /* padWidth * (window height + 2) */
+    coordinate_t min;     /* window corner */
+    long srcIndex;
+    long dstIndex;
+    long distance;        /* of the destination; -1 if not reached */
+    index_list_t lists[2];
+};
+
+
+/* =============================================================================
+ * getCode
+ * =============================================================================
+ */
+static inline long getCode (akers_t* akersPtr, long index){
+    return (long)((akersPtr->words[index >> 5] >> ((index & 31) << 1)) & 3);
+}
+
+
+/* =============================================================================
+ * setCode
+ * =============================================================================
+ */
+static inline void setCode (akers_t* akersPtr, long index, long code){
+    uint64_t* wordPtr = &akersPtr->words[index >> 5];
+    long shift = (index & 31) << 1;
+    *wordPtr = (*wordPtr & ~((uint64_t)3 << shift)) | ((uint64_t)code << shift);
+}
+
+
+/* =============================================================================
+ * pushIndex
+ * =============================================================================
+ */
+static inline void pushIndex (index_list_t* listPtr, long index){
+    if (listPtr->size == listPtr->capacity) {
+        long newCapacity = 2 * listPtr->capacity;
+        long* newElements = (long*)realloc(listPtr->elements, newCapacity * sizeof(long));
+        assert(newElements);
+        listPtr->elements = newElements;
+        listPtr->capacity = newCapacity;
+    }
+    listPtr->elements[listPtr->size++] = index;
+}
+
+
+/* =============================================================================
+ * getIndex
+ * =============================================================================
+ */
+static inline long getIndex (akers_t* akersPtr, coordinate_t* coordinatePtr){
+    return ((coordinatePtr->z - akersPtr->min.z + 1) * akersPtr->padArea +
+            (coordinatePtr->y - akersPtr->min.y + 1) * akersPtr->padWidth +
+            (coordinatePtr->x - akersPtr->min.x + 1));
+}
+
+
+/* =============================================================================
+ * getGridPointRef
+ * =============================================================================
+ */
+static inline grid_point_t* getGridPointRef (akers_t* akersPtr, grid_t* gridPtr, long index){
+    long x = (index % akersPtr->padWidth) - 1 + akersPtr->min.x;
+    long y = ((index % akersPtr->padArea) / akersPtr->padWidth) - 1 + akersPtr->min.y;
+    long z = (index / akersPtr->padArea) - 1 + akersPtr->min.z;
+    return grid_getPointRef(gridPtr, x, y, z);
+}
+
+
+/* =============================================================================
+ * akers_isSupported
+ * -- TRUE if xCost == yCost == zCost >= 1
+ * =============================================================================
+ */
+bool_t akers_isSupported (long xCost, long yCost, long zCost){
+    return ((xCost >= 1 && yCost == xCost && zCost == xCost) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * akers_alloc
+ * =============================================================================
+ */
+akers_t* akers_alloc (){
+    akers_t* akersPtr;
+
+    akersPtr = (akers_t*)malloc(sizeof(akers_t));
+    if (akersPtr) {
+        akersPtr->words = NULL;
+        akersPtr->capacity = 0;
+        akersPtr->distance = -1;
+        long l;
+        for (l = 0; l < 2; l++) {
+            index_list_t* listPtr = &akersPtr->lists[l];
+            listPtr->elements = (long*)malloc(AKERS_LIST_INIT_CAPACITY * sizeof(long));
+            assert(listPtr->elements);
+            listPtr->size = 0;
+            listPtr->capacity = AKERS_LIST_INIT_CAPACITY;
+        }
+    }
+
+    return akersPtr;
+}
+
+
+/* =============================================================================
+ * akers_free
+ * =============================================================================
+ */
+void akers_free (akers_t* akersPtr){
+    free(akersPtr->lists[0].elements);
+    free(akersPtr->lists[1].elements);
+    free(akersPtr->words);
+    free(akersPtr);
+}
+
+
+/* =============================================================================
+ * loadWindow
+ * -- Blocks the whole private grid, then frees the window's empty points
+ * =============================================================================
+ */
+static void loadWindow (akers_t* akersPtr, occupancy_t* occupancyPtr, coordinate_t* minPtr, coordinate_t* maxPtr, akers_stats_t* statsPtr){
+    long numX = maxPtr->x - minPtr->x + 1;
+    long numY = maxPtr->y - minPtr->y + 1;
+    long numZ = maxPtr->z - minPtr->z + 1;
+    long numWord;
+
+    akersPtr->min = *minPtr;
+    akersPtr->padWidth = numX + 2;
+    akersPtr->padArea = akersPtr->padWidth * (numY + 2);
+    numWord = (akersPtr->padArea * (numZ + 2) + 31) / 32;
+    if (numWord > akersPtr->capacity) {
+        free(akersPtr->words);
+        akersPtr->words = (uint64_t*)malloc(numWord * sizeof(uint64_t));
+        assert(akersPtr->words);
+        akersPtr->capacity = numWord;
+        if ((long)(numWord * sizeof(uint64_t)) > statsPtr->numByte) {
+            statsPtr->numByte = numWord * sizeof(uint64_t);
+        }
+    }
+    memset(akersPtr->words, 0xFF, numWord * sizeof(uint64_t)); /* AKERS_BLOCKED */
+
+    long y;
+    long z;
+    for (z = 0; z < numZ; z++) {
+        for (y = 0; y < numY; y++) {
+            long rowIndex = (z + 1) * akersPtr->padArea + (y + 1) * akersPtr->padWidth + 1;
+            long x;
+            for (x = 0; x < numX; x++) {
+                if (!occupancy_isPointFull(occupancyPtr, minPtr->x + x, minPtr->y + y, minPtr->z + z)) {
+                    setCode(akersPtr, rowIndex + x, AKERS_FREE);
+                }
+            }
+        }
+    }
+}
+
+
+/* =============================================================================
+ * akers_expand
+ * -- Reads the box [minPtr, maxPtr] of the shared occupancy into a private grid
+ *    of 2 bits per point and floods it from srcPtr until dstPtr is labeled
+ * -- Returns TRUE if dstPtr was reached
+ * =============================================================================
+ */
+bool_t akers_expand (akers_t* akersPtr, occupancy_t* occupancyPtr, coordinate_t* minPtr, coordinate_t* maxPtr, coordinate_t* srcPtr, coordinate_t* dstPtr, akers_stats_t* statsPtr){
+    loadWindow(akersPtr, occupancyPtr, minPtr, maxPtr, statsPtr);
+
+    long offsets[6] = { 1, -1, akersPtr->padWidth, -akersPtr->padWidth, akersPtr->padArea, -akersPtr->padArea };
+    long srcIndex = getIndex(akersPtr, srcPtr);
+    long dstIndex = getIndex(akersPtr, dstPtr);
+    akersPtr->srcIndex = srcIndex;
+    akersPtr->dstIndex = dstIndex;
+    akersPtr->distance = -1;
+    setCode(akersPtr, srcIndex, AKERS_LABEL(0));
+    setCode(akersPtr, dstIndex, AKERS_FREE);
+
+    index_list_t* currListPtr = &akersPtr->lists[0];
+    index_list_t* nextListPtr = &akersPtr->lists[1];
+    currListPtr->size = 0;
+    pushIndex(currListPtr, srcIndex);
+
+    long d;
+    for (d = 1; currListPtr->size > 0; d++) {
+        long label = AKERS_LABEL(d);
+        long i;
+        nextListPtr->size = 0;
+        for (i = 0; i < currListPtr->size; i++) {
+            long index = currListPtr->elements[i];
+            long n;
+            statsPtr->numCellExpanded++;
+            for (n = 0; n < 6; n++) {
+                long neighbor = index + offsets[n];
+                if (getCode(akersPtr, neighbor) == AKERS_FREE) {
+                    setCode(akersPtr, neighbor, label);
+                    if (neighbor == dstIndex) {
+                        akersPtr->distance = d;
+                        return TRUE;
+                    }
+                    pushIndex(nextListPtr, neighbor);
+                }
+            }
+        }
+        index_list_t* tmpListPtr = currListPtr;
+        currListPtr = nextListPtr;
+        nextListPtr = tmpListPtr;
+    }
+
+    return FALSE;
+}
+
+
+/* =============================================================================
+ * akers_traceback
+ * -- Appends the path found by the last akers_expand to pointVectorPtr, as
+ *    indices into gridPtr from destination to source
+ * -- Returns FALSE on failure
+ * =============================================================================
+ */
+bool_t akers_traceback (akers_t* akersPtr, grid_t* gridPtr, indexvector_t* pointVectorPtr){
+    long distance = akersPtr->distance;
+    if (distance < 0) {
+        return FALSE;
+    }
+
+    long offsets[6] = { 1, -1, akersPtr->padWidth, -akersPtr->padWidth, akersPtr->padArea, -akersPtr->padArea };
+    long index = akersPtr->dstIndex;
+    long lastMove = 0;
+
+    /* Every step costs one, so the path has exactly distance + 1 points */
+    bool_t status = indexvector_reserve(pointVectorPtr, indexvector_getSize(pointVectorPtr) + distance + 1);
+    assert(status);
+    indexvector_pushBack(pointVectorPtr, getGridPointRef(akersPtr, gridPtr, index) - gridPtr->points);
+
+    while (distance > 0) {
+        long label = AKERS_LABEL(distance - 1);
+        long m;
+        long move = -1;
+        /* Keep going straight when possible, as the bend cost asks */
+        for (m = -1; m < 6; m++) {
+            long candidate = ((m < 0) ? lastMove : m);
+            if (getCode(akersPtr, index + offsets[candidate]) == label) {
+                move = candidate;
+                break;
+            }
+        }
+        if (move < 0) {
+            return FALSE;
+        }
+        index += offsets[move];
+        distance--;
+        lastMove = move;
+        indexvector_pushBack(pointVectorPtr, getGridPointRef(akersPtr, gridPtr, index) - gridPtr->points);
+    }
+
+    assert(index == akersPtr->srcIndex);
+
+    return TRUE;
+}
+
+
+/* =============================================================================
+ *
+ * End of akers.c
+ *
+ * =============================================================================
+ */
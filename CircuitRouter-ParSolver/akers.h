@@ -0,0 +1,122 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * akers.h
+ *
+ * =============================================================================
+ */
+
+
+#ifndef AKERS_H
+#define AKERS_H 1
+
+
+#include "coordinate.h"
+#include "grid.h"
+#include "occupancy.h"
+#include "path.h"
+#include "lib/types.h"
+
+typedef struct akers akers_t;
+
+typedef struct akers_stats {
+    long numCellExpanded; /* points whose neighbors were labeled */
+    long numByte;         /* size of the largest private grid so far */
+} akers_stats_t;
+
+
+/* =============================================================================
+ * akers_isSupported
+ * -- TRUE if xCost == yCost == zCost >= 1
+ * =============================================================================
+ */
+bool_t akers_isSupported (long xCost, long yCost, long zCost);
+
+
+/* =============================================================================
+ * akers_alloc
+ * =============================================================================
+ */
+akers_t* akers_alloc ();
+
+
+/* =============================================================================
+ * akers_free
+ * =============================================================================
+ */
+void akers_free (akers_t* akersPtr);
+
+
+/* =============================================================================
+ * akers_expand
+ * -- Reads the box [minPtr, maxPtr] of the shared occupancy into a private grid
+ *    of 2 bits per point and floods it from srcPtr until dstPtr is labeled
+ * -- Returns TRUE if dstPtr was reached
+ * =============================================================================
+ */
+bool_t akers_expand (akers_t* akersPtr, occupancy_t* occupancyPtr, coordinate_t* minPtr, coordinate_t* maxPtr, coordinate_t* srcPtr, coordinate_t* dstPtr, akers_stats_t* statsPtr);
+
+
+/* =============================================================================
+ * akers_traceback
+ * -- Appends the path found by the last akers_expand to pointVectorPtr, as
+ *    indices into gridPtr from destination to source
+ * -- Returns FALSE on failure
+ * =============================================================================
+ */
+bool_t akers_traceback (akers_t* akersPtr, grid_t* gridPtr, indexvector_t* pointVectorPtr);
+
+
+#endif /* AKERS_H */
+
+
+/* =============================================================================
+ *
+ * End of akers.h
+ *
+ * =============================================================================
+ */
@@ -0,0 +1,622 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * bitwave.c
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bitwave.h"
+#include "coordinate.h"
+#include "grid.h"
+#include "occupancy.h"
+#include "path.h"
+#include "lib/types.h"
+#include "lib/utility.h"
+#if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#  define BITWAVE_HAVE_X86 1
+#endif
+
+
+/*
+ * Bit-parallel Lee expansion.
+ *
+ * The window is copied from the occupancy into bitsets, one bit per point:
+ * 'free' for points that may be entered, 'visited' for points already
+ * reached, and one frontier per wave of the last zWave waves. Rows are stored with a zero
+ * guard word on each side and the window with a zero guard row and layer
+ * on each side, so a whole row shifts by one point with plain word shifts
+ * and the kernel never tests bounds. A point enters wave w if it is free,
+ * unvisited, and next to wave w - 1 in its layer or to wave w - zWave in an
+ * adjacent layer.
+ *
+ * No point is labeled: each wave's nonzero words are appended to a record,
+ * and the traceback looks up only the points next to the path it walks.
+ */
+
+typedef bool_t (*kernel_t)(uint64_t* nextPtr, const uint64_t* curPtr, const uint64_t* zPtr, const uint64_t* freePtr, uint64_t* visitedPtr, long begin, long end, long rowStride, long layerStride);
+
+struct bitwave {
+    long cost;            /* xCost == yCost */
+    long zWave;           /* zCost / cost */
+    long numFront;        /* zWave + 1 */
+    kernel_t kernel;
+    uint64_t* words;
+    long capacity;
+    uint64_t* freePtr;
+    uint64_t* visitedPtr;
+    uint64_t** frontPtrs; /* wave w is frontPtrs[w % numFront] */
+    long rowStride;       /* words per row, guards included */
+    long layerStride;     /* words per layer, guard rows included */
+    coordinate_t min;     /* window of the last expansion */
+    coordinate_t dst;     /* its destination, in window coordinates */
+    long dstWave;         /* wave that reached dst, or -1 */
+    uint32_t* recordIndices; /* nonzero frontier words of every wave so far */
+    uint64_t* recordWords;
+    long numRecordWord;
+    long recordCapacity;
+    long* waveStarts;     /* wave w is record entries [waveStarts[w], waveStarts[w + 1]) */
+    long waveCapacity;
+};
+
+
+/* =============================================================================
+ * expandScalar
+ * -- Computes the wave for words [begin, end) and returns TRUE if any point
+ *    entered it
+ * =============================================================================
+ */
+static bool_t expandScalar (uint64_t* nextPtr, const uint64_t* curPtr, const uint64_t* zPtr, const uint64_t* freePtr, uint64_t* visitedPtr, long begin, long end, long rowStride, long layerStride){
+    uint64_t any = 0;
+    long i;
+
+    for (i = begin; i < end; i++) {
+        uint64_t cur = curPtr[i];
+        uint64_t reach = ((cur << 1) | (curPtr[i-1] >> 63) |
+                          (cur >> 1) | (curPtr[i+1] << 63) |
+                          curPtr[i-rowStride] | curPtr[i+rowStride] |
+                          zPtr[i-layerStride] | zPtr[i+layerStride]);
+        uint64_t next = reach & freePtr[i] & ~visitedPtr[i];
+        nextPtr[i] = next;
+        visitedPtr[i] |= next;
+        any |= next;
+    }
+
+    return ((any != 0) ? TRUE : FALSE);
+}
+
+
+#ifdef BITWAVE_HAVE_X86
+
+/* =============================================================================
+ * expandSse2
+ * -- Two words per step; the carries between words come from loads shifted
+ *    by one word, which the guard words make safe at the row ends
+ * =============================================================================
+ */
+__attribute__((target("sse2")))
+static bool_t expandSse2 (uint64_t* nextPtr, const uint64_t* curPtr, const uint64_t* zPtr, const uint64_t* freePtr, uint64_t* visitedPtr, long begin, long end, long rowStride, long layerStride){
+    __m128i any = _mm_setzero_si128();
+    long i;
+
+    for (i = begin; i + 2 <= end; i += 2) {
+        __m128i cur   = _mm_loadu_si128((const __m128i*)(curPtr + i));
+        __m128i left  = _mm_loadu_si128((const __m128i*)(curPtr + i - 1));
+        __m128i right = _mm_loadu_si128((const __m128i*)(curPtr + i + 1));
+        __m128i reach = _mm_or_si128(_mm_slli_epi64(cur, 1), _mm_srli_epi64(left, 63));
+        reach = _mm_or_si128(reach, _mm_srli_epi64(cur, 1));
+        reach = _mm_or_si128(reach, _mm_slli_epi64(right, 63));
+        reach = _mm_or_si128(reach, _mm_loadu_si128((const __m128i*)(curPtr + i - rowStride)));
+        reach = _mm_or_si128(reach, _mm_loadu_si128((const __m128i*)(curPtr + i + rowStride)));
+        reach = _mm_or_si128(reach, _mm_loadu_si128((const __m128i*)(zPtr + i - layerStride)));
+        reach = _mm_or_si128(reach, _mm_loadu_si128((const __m128i*)(zPtr + i + layerStride)));
+        __m128i visited = _mm_loadu_si128((const __m128i*)(visitedPtr + i));
+        __m128i next = _mm_andnot_si128(visited,
+                                        _mm_and_si128(reach, _mm_loadu_si128((const __m128i*)(freePtr + i))));
+        _mm_storeu_si128((__m128i*)(nextPtr + i), next);
+        _mm_storeu_si128((__m128i*)(visitedPtr + i), _mm_or_si128(visited, next));
+        any = _mm_or_si128(any, next);
+    }
+
+    bool_t isAny = ((_mm_movemask_epi8(_mm_cmpeq_epi8(any, _mm_setzero_si128())) != 0xFFFF) ? TRUE : FALSE);
+    if (expandScalar(nextPtr, curPtr, zPtr, freePtr, visitedPtr, i, end, rowStride, layerStride)) {
+        isAny = TRUE;
+    }
+
+    return isAny;
+}
+
+
+/* =============================================================================
+ * expandAvx2
+ * -- Four words per step, as expandSse2
+ * =============================================================================
+ */
+__attribute__((target("avx2")))
+static bool_t expandAvx2 (uint64_t* nextPtr, const uint64_t* curPtr, const uint64_t* zPtr, const uint64_t* freePtr, uint64_t* visitedPtr, long begin, long end, long rowStride, long layerStride){
+    __m256i any = _mm256_setzero_si256();
+    long i;
+
+    for (i = begin; i + 4 <= end; i += 4) {
+        __m256i cur   = _mm256_loadu_si256((const __m256i*)(curPtr + i));
+        __m256i left  = _mm256_loadu_si256((const __m256i*)(curPtr + i - 1));
+        __m256i right = _mm256_loadu_si256((const __m256i*)(curPtr + i + 1));
+        __m256i reach = _mm256_or_si256(_mm256_slli_epi64(cur, 1), _mm256_srli_epi64(left, 63));
+        reach = _mm256_or_si256(reach, _mm256_srli_epi64(cur, 1));
+        reach = _mm256_or_si256(reach, _mm256_slli_epi64(right, 63));
+        reach = _mm256_or_si256(reach, _mm256_loadu_si256((const __m256i*)(curPtr + i - rowStride)));
+        reach = _mm256_or_si256(reach, _mm256_loadu_si256((const __m256i*)(curPtr + i + rowStride)));
+        reach = _mm256_or_si256(reach, _mm256_loadu_si256((const __m256i*)(zPtr + i - layerStride)));
+        reach = _mm256_or_si256(reach, _mm256_loadu_si256((const __m256i*)(zPtr + i + layerStride)));
+        __m256i visited = _mm256_loadu_si256((const __m256i*)(visitedPtr + i));
+        __m256i next = _mm256_andnot_si256(visited,
+                                           _mm256_and_si256(reach, _mm256_loadu_si256((const __m256i*)(freePtr + i))));
+        _mm256_storeu_si256((__m256i*)(nextPtr + i), next);
+        _mm256_storeu_si256((__m256i*)(visitedPtr + i), _mm256_or_si256(visited, next));
+        any = _mm256_or_si256(any, next);
+    }
+
+    bool_t isAny = (_mm256_testz_si256(any, any) ? FALSE : TRUE);
+    if (expandScalar(nextPtr, curPtr, zPtr, freePtr, visitedPtr, i, end, rowStride, layerStride)) {
+        isAny = TRUE;
+    }
+
+    return isAny;
+}
+
+#endif /* BITWAVE_HAVE_X86 */
+
+
+/* =============================================================================
+ * selectKernel
+ * =============================================================================
+ */
+static kernel_t selectKernel (const char** namePtr){
+#ifdef BITWAVE_HAVE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        *namePtr = "avx2";
+        return expandAvx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        *namePtr = "sse2";
+        return expandSse2;
+    }
+#endif
+    *namePtr = "scalar";
+    return expandScalar;
+}
+
+
+/* =============================================================================
+ * bitwave_isSupported
+ * -- TRUE if xCost == yCost >= 1 and zCost is a multiple of it
+ * =============================================================================
+ */
+bool_t bitwave_isSupported (long xCost, long yCost, long zCost){
+    return ((xCost >= 1 && yCost == xCost && zCost >= xCost && (zCost % xCost) == 0) ?
+            TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * bitwave_getKernelName
+ * -- Instruction set of the kernel picked for this machine
+ * =============================================================================
+ */
+const char* bitwave_getKernelName (){
+    const char* name;
+    selectKernel(&name);
+    return name;
+}
+
+
+/* =============================================================================
+ * bitwave_alloc
+ * -- Costs must satisfy bitwave_isSupported
+ * =============================================================================
+ */
+bitwave_t* bitwave_alloc (long xCost, long yCost, long zCost){
+    bitwave_t* bitwavePtr;
+
+    assert(bitwave_isSupported(xCost, yCost, zCost));
+
+    bitwavePtr = (bitwave_t*)malloc(sizeof(bitwave_t));
+    if (bitwavePtr) {
+        const char* name;
+        bitwavePtr->cost = xCost;
+        bitwavePtr->zWave = zCost / xCost;
+        bitwavePtr->numFront = bitwavePtr->zWave + 1;
+        bitwavePtr->kernel = selectKernel(&name);
+        bitwavePtr->words = NULL;
+        bitwavePtr->capacity = 0;
+        bitwavePtr->dstWave = -1;
+        bitwavePtr->recordIndices = NULL;
+        bitwavePtr->recordWords = NULL;
+        bitwavePtr->numRecordWord = 0;
+        bitwavePtr->recordCapacity = 0;
+        bitwavePtr->waveStarts = NULL;
+        bitwavePtr->waveCapacity = 0;
+        bitwavePtr->frontPtrs = (uint64_t**)malloc(bitwavePtr->numFront * sizeof(uint64_t*));
+        if (bitwavePtr->frontPtrs == NULL) {
+            free(bitwavePtr);
+            return NULL;
+        }
+    }
+
+    return bitwavePtr;
+}
+
+
+/* =============================================================================
+ * bitwave_free
+ * =============================================================================
+ */
+void bitwave_free (bitwave_t* bitwavePtr){
+    free(bitwavePtr->words);
+    free(bitwavePtr->recordIndices);
+    free(bitwavePtr->recordWords);
+    free(bitwavePtr->waveStarts);
+    free(bitwavePtr->frontPtrs);
+    free(bitwavePtr);
+}
+
+
+/* =============================================================================
+ * loadWindow
+ * -- Sizes and clears the bitsets for the box [minPtr, maxPtr] and marks the
+ *    points the occupancy leaves free, a row at a time
+ * =============================================================================
+ */
+static void loadWindow (bitwave_t* bitwavePtr, occupancy_t* occupancyPtr, coordinate_t* minPtr, coordinate_t* maxPtr){
+    long numX = maxPtr->x - minPtr->x + 1;
+    long numY = maxPtr->y - minPtr->y + 1;
+    long numZ = maxPtr->z - minPtr->z + 1;
+    long numRowWord = (((numX + 63) / 64) + 3) & ~3L; /* whole AVX2 vectors */
+    long rowStride = numRowWord + 2;
+    long layerStride = (numY + 2) * rowStride;
+    long numWord = (numZ + 2) * layerStride;
+    long numTotal = (2 + bitwavePtr->numFront) * numWord;
+    long f;
+
+    if (numTotal > bitwavePtr->capacity) {
+        free(bitwavePtr->words);
+        bitwavePtr->words = (uint64_t*)malloc(numTotal * sizeof(uint64_t));
+        assert(bitwavePtr->words);
+        bitwavePtr->capacity = numTotal;
+    }
+    memset(bitwavePtr->words, 0, numTotal * sizeof(uint64_t));
+    bitwavePtr->freePtr = bitwavePtr->words;
+    bitwavePtr->visitedPtr = bitwavePtr->words + numWord;
+    for (f = 0; f < bitwavePtr->numFront; f++) {
+        bitwavePtr->frontPtrs[f] = bitwavePtr->words + (2 + f) * numWord;
+    }
+    bitwavePtr->rowStride = rowStride;
+    bitwavePtr->layerStride = layerStride;
+    bitwavePtr->min = *minPtr;
+
+    long y;
+    long z;
+    for (z = 0; z < numZ; z++) {
+        for (y = 0; y < numY; y++) {
+            uint64_t* rowPtr = bitwavePtr->freePtr + (z + 1) * layerStride + (y + 1) * rowStride + 1;
+            occupancy_getFreeRow(occupancyPtr, minPtr->x, minPtr->y + y, minPtr->z + z, numX, rowPtr);
+        }
+    }
+}
+
+
+/* =============================================================================
+ * getWordIndex
+ * -- Word holding window point (x, y, z); its bit is x & 63
+ * =============================================================================
+ */
+static inline long getWordIndex (bitwave_t* bitwavePtr, long x, long y, long z){
+    return ((z + 1) * bitwavePtr->layerStride + (y + 1) * bitwavePtr->rowStride + 1 + (x >> 6));
+}
+
+
+/* =============================================================================
+ * reserveRecord
+ * -- Makes room for numWord more words in the wave record and for the start
+ *    of wave w + 1
+ * =============================================================================
+ */
+static void reserveRecord (bitwave_t* bitwavePtr, long w, long numWord){
+    if (bitwavePtr->numRecordWord + numWord > bitwavePtr->recordCapacity) {
+        long capacity = MAX(2 * bitwavePtr->recordCapacity, bitwavePtr->numRecordWord + numWord);
+        bitwavePtr->recordIndices = (uint32_t*)realloc(bitwavePtr->recordIndices, capacity * sizeof(uint32_t));
+        bitwavePtr->recordWords = (uint64_t*)realloc(bitwavePtr->recordWords, capacity * sizeof(uint64_t));
+        assert(bitwavePtr->recordIndices && bitwavePtr->recordWords);
+        bitwavePtr->recordCapacity = capacity;
+    }
+    if (w + 2 > bitwavePtr->waveCapacity) {
+        long capacity = MAX(2 * bitwavePtr->waveCapacity, w + 2);
+        bitwavePtr->waveStarts = (long*)realloc(bitwavePtr->waveStarts, capacity * sizeof(long));
+        assert(bitwavePtr->waveStarts);
+        bitwavePtr->waveCapacity = capacity;
+    }
+}
+
+
+/* =============================================================================
+ * recordWave
+ * -- Appends the words of nextPtr in [begin, end) with a point set to the
+ *    wave record; returns how many points they hold
+ * -- Room for end - begin words must have been reserved
+ * =============================================================================
+ */
+static long recordWave (bitwave_t* bitwavePtr, const uint64_t* nextPtr, long begin, long end){
+    uint32_t* recordIndices = bitwavePtr->recordIndices;
+    uint64_t* recordWords = bitwavePtr->recordWords;
+    long n = bitwavePtr->numRecordWord;
+    long numPoint = 0;
+    long i;
+
+    for (i = begin; i < end; i++) {
+        uint64_t word = nextPtr[i];
+        if (word) {
+            recordIndices[n] = (uint32_t)i;
+            recordWords[n] = word;
+            n++;
+            numPoint += __builtin_popcountll(word);
+        }
+    }
+    bitwavePtr->numRecordWord = n;
+
+    return numPoint;
+}
+
+
+/* =============================================================================
+ * isInWave
+ * -- TRUE if the point at bit 'bit' of word wordIndex entered wave w; the
+ *    words of a wave are recorded in increasing order
+ * =============================================================================
+ */
+static bool_t isInWave (bitwave_t* bitwavePtr, long w, long wordIndex, uint64_t bit){
+    long lo = bitwavePtr->waveStarts[w];
+    long hi = bitwavePtr->waveStarts[w + 1];
+    long end = hi;
+
+    while (lo < hi) {
+        long mid = (lo + hi) / 2;
+        if ((long)bitwavePtr->recordIndices[mid] < wordIndex) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return ((lo < end &&
+             (long)bitwavePtr->recordIndices[lo] == wordIndex &&
+             (bitwavePtr->recordWords[lo] & bit)) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * bitwave_expand
+ * -- Reads the box [minPtr, maxPtr] of the shared occupancy into bitsets and
+ *    floods it from srcPtr one wave at a time until dstPtr is reached
+ * -- Only the words each wave set are kept, for bitwave_traceback
+ * -- Returns TRUE if dstPtr was reached
+ * =============================================================================
+ */
+bool_t bitwave_expand (bitwave_t* bitwavePtr, occupancy_t* occupancyPtr, coordinate_t* minPtr, coordinate_t* maxPtr, coordinate_t* srcPtr, coordinate_t* dstPtr, bitwave_stats_t* statsPtr){
+    long numY = maxPtr->y - minPtr->y + 1;
+    long numZ = maxPtr->z - minPtr->z + 1;
+    long numFront = bitwavePtr->numFront;
+    long zWave = bitwavePtr->zWave;
+
+    bitwavePtr->dstWave = -1;
+    loadWindow(bitwavePtr, occupancyPtr, minPtr, maxPtr);
+
+    long rowStride = bitwavePtr->rowStride;
+    long layerStride = bitwavePtr->layerStride;
+    long srcX = srcPtr->x - minPtr->x;
+    long srcY = srcPtr->y - minPtr->y;
+    long srcZ = srcPtr->z - minPtr->z;
+    long dstX = dstPtr->x - minPtr->x;
+    long dstY = dstPtr->y - minPtr->y;
+    long dstZ = dstPtr->z - minPtr->z;
+    long srcIndex = getWordIndex(bitwavePtr, srcX, srcY, srcZ);
+    long dstIndex = getWordIndex(bitwavePtr, dstX, dstY, dstZ);
+    uint64_t srcBit = (uint64_t)1 << (srcX & 63);
+    uint64_t dstBit = (uint64_t)1 << (dstX & 63);
+    bitwavePtr->visitedPtr[srcIndex] |= srcBit;
+    bitwavePtr->frontPtrs[0][srcIndex] |= srcBit;
+    bitwavePtr->freePtr[dstIndex] |= dstBit; /* end points are set in the occupancy */
+
+    bitwavePtr->numRecordWord = 0;
+    reserveRecord(bitwavePtr, 0, 1);
+    bitwavePtr->waveStarts[0] = 0;
+    recordWave(bitwavePtr, bitwavePtr->frontPtrs[0], srcIndex, srcIndex + 1);
+    bitwavePtr->waveStarts[1] = bitwavePtr->numRecordWord;
+
+    long numEmptyWave = 0;
+    bool_t isFound = FALSE;
+    long w;
+
+    for (w = 1; ; w++) {
+
+        uint64_t* curPtr = bitwavePtr->frontPtrs[(w - 1) % numFront];
+        uint64_t* zPtr = bitwavePtr->frontPtrs[(w - zWave + numFront) % numFront];
+        uint64_t* nextPtr = bitwavePtr->frontPtrs[w % numFront];
+
+        /*
+         * Wave w lies within w rows and w / zWave layers of the source; the
+         * same rows of older waves are overwritten, so nothing stale is left
+         */
+        long yLo = ((srcY - w > 0) ? (srcY - w) : 0);
+        long yHi = ((srcY + w < numY - 1) ? (srcY + w) : (numY - 1));
+        long zLo = ((srcZ - w / zWave > 0) ? (srcZ - w / zWave) : 0);
+        long zHi = ((srcZ + w / zWave < numZ - 1) ? (srcZ + w / zWave) : (numZ - 1));
+        bool_t isAny = FALSE;
+        long z;
+
+        for (z = zLo; z <= zHi; z++) {
+            long begin = (z + 1) * layerStride + (yLo + 1) * rowStride;
+            long end = (z + 1) * layerStride + (yHi + 2) * rowStride;
+            reserveRecord(bitwavePtr, w, end - begin);
+            if (bitwavePtr->kernel(nextPtr, curPtr, zPtr,
+                                   bitwavePtr->freePtr, bitwavePtr->visitedPtr,
+                                   begin, end, rowStride, layerStride))
+            {
+                isAny = TRUE;
+                statsPtr->numCellExpanded += recordWave(bitwavePtr, nextPtr, begin, end);
+            }
+        }
+        bitwavePtr->waveStarts[w + 1] = bitwavePtr->numRecordWord;
+        statsPtr->numWave++;
+
+        if (!isAny) {
+            if (++numEmptyWave >= zWave) {
+                break; /* no older wave can reach further */
+            }
+            continue;
+        }
+        numEmptyWave = 0;
+
+        if (nextPtr[dstIndex] & dstBit) {
+            bitwavePtr->dst.x = dstX;
+            bitwavePtr->dst.y = dstY;
+            bitwavePtr->dst.z = dstZ;
+            bitwavePtr->dstWave = w;
+            isFound = TRUE;
+            break;
+        }
+    }
+
+    long numByte = (bitwavePtr->capacity + bitwavePtr->recordCapacity) * sizeof(uint64_t) +
+                   bitwavePtr->recordCapacity * sizeof(uint32_t) +
+                   bitwavePtr->waveCapacity * sizeof(long);
+    if (numByte > statsPtr->numByte) {
+        statsPtr->numByte = numByte;
+    }
+
+    return isFound;
+}
+
+
+/* =============================================================================
+ * bitwave_traceback
+ * -- Appends the path found by the last bitwave_expand to pointVectorPtr, as
+ *    indices into gridPtr from destination to source
+ * -- Each step goes back to a neighbor that entered the wave one step cost
+ *    earlier, found by a search of that wave's recorded words
+ * -- Returns FALSE on failure
+ * =============================================================================
+ */
+bool_t bitwave_traceback (bitwave_t* bitwavePtr, grid_t* gridPtr, indexvector_t* pointVectorPtr){
+    static const long moves[6][3] = {
+        { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }
+    };
+    coordinate_t* minPtr = &bitwavePtr->min;
+    long w = bitwavePtr->dstWave;
+    if (w < 0) {
+        return FALSE;
+    }
+
+    long x = bitwavePtr->dst.x;
+    long y = bitwavePtr->dst.y;
+    long z = bitwavePtr->dst.z;
+    long lastMove = 0;
+
+    /* Every step goes back at least one wave */
+    bool_t status = indexvector_reserve(pointVectorPtr, indexvector_getSize(pointVectorPtr) + w + 1);
+    assert(status);
+    indexvector_pushBack(pointVectorPtr,
+                         grid_getPointRef(gridPtr, minPtr->x + x, minPtr->y + y, minPtr->z + z) - gridPtr->points);
+
+    while (w > 0) {
+        long m;
+        long move = -1;
+        /* Keep going straight when possible, as the bend cost asks */
+        for (m = -1; m < 6; m++) {
+            long candidate = ((m < 0) ? lastMove : m);
+            long prevWave = w - ((moves[candidate][2] != 0) ? bitwavePtr->zWave : 1);
+            if (prevWave < 0) {
+                continue;
+            }
+            long nx = x + moves[candidate][0];
+            long ny = y + moves[candidate][1];
+            long nz = z + moves[candidate][2];
+            if (isInWave(bitwavePtr, prevWave,
+                         getWordIndex(bitwavePtr, nx, ny, nz), (uint64_t)1 << (nx & 63)))
+            {
+                move = candidate;
+                w = prevWave;
+                break;
+            }
+        }
+        if (move < 0) {
+            return FALSE;
+        }
+        x += moves[move][0];
+        y += moves[move][1];
+        z += moves[move][2];
+        lastMove = move;
+        indexvector_pushBack(pointVectorPtr,
+                             grid_getPointRef(gridPtr, minPtr->x + x, minPtr->y + y, minPtr->z + z) - gridPtr->points);
+    }
+
+    return TRUE;
+}
+
+
+/* =============================================================================
+ *
+ * End of bitwave.c
+ *
+ * =============================================================================
+ */
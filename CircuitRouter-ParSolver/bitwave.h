@@ -0,0 +1,132 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * bitwave.h
+ *
+ * =============================================================================
+ */
+
+
+#ifndef BITWAVE_H
+#define BITWAVE_H 1
+
+
+#include "coordinate.h"
+#include "grid.h"
+#include "occupancy.h"
+#include "path.h"
+#include "lib/types.h"
+
+typedef struct bitwave bitwave_t;
+
+typedef struct bitwave_stats {
+    long numCellExpanded; /* points reached */
+    long numWave;         /* waves advanced */
+    long numByte;         /* size of the largest bitsets and wave record so far */
+} bitwave_stats_t;
+
+
+/* =============================================================================
+ * bitwave_isSupported
+ * -- TRUE if xCost == yCost >= 1 and zCost is a multiple of it
+ * =============================================================================
+ */
+bool_t bitwave_isSupported (long xCost, long yCost, long zCost);
+
+
+/* =============================================================================
+ * bitwave_getKernelName
+ * -- Instruction set of the kernel picked for this machine
+ * =============================================================================
+ */
+const char* bitwave_getKernelName ();
+
+
+/* =============================================================================
+ * bitwave_alloc
+ * -- Costs must satisfy bitwave_isSupported
+ * =============================================================================
+ */
+bitwave_t* bitwave_alloc (long xCost, long yCost, long zCost);
+
+
+/* =============================================================================
+ * bitwave_free
+ * =============================================================================
+ */
+void bitwave_free (bitwave_t* bitwavePtr);
+
+
+/* =============================================================================
+ * bitwave_expand
+ * -- Reads the box [minPtr, maxPtr] of the shared occupancy into bitsets and
+ *    floods it from srcPtr one wave at a time until dstPtr is reached
+ * -- Returns TRUE if dstPtr was reached
+ * =============================================================================
+ */
+bool_t bitwave_expand (bitwave_t* bitwavePtr, occupancy_t* occupancyPtr, coordinate_t* minPtr, coordinate_t* maxPtr, coordinate_t* srcPtr, coordinate_t* dstPtr, bitwave_stats_t* statsPtr);
+
+
+/* =============================================================================
+ * bitwave_traceback
+ * -- Appends the path found by the last bitwave_expand to pointVectorPtr, as
+ *    indices into gridPtr from destination to source
+ * -- Returns FALSE on failure
+ * =============================================================================
+ */
+bool_t bitwave_traceback (bitwave_t* bitwavePtr, grid_t* gridPtr, indexvector_t* pointVectorPtr);
+
+
+#endif /* BITWAVE_H */
+
+
+/* =============================================================================
+ *
+ * End of bitwave.h
+ *
+ * =============================================================================
+ */
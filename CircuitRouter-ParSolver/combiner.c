@@ -0,0 +1,239 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * combiner.c
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "combiner.h"
+#include "lib/types.h"
+
+
+/*
+ * Flat combining: a thread with work for the shared structure writes it to
+ * its own slot and tries the lock. Whoever gets the lock sweeps every slot
+ * and applies all pending requests in one go, so a burst of N requests costs
+ * one lock handoff instead of N. The others wait on their own slot, a line
+ * nobody else writes until the answer is in, and take the lock themselves
+ * if it comes free before then. Waiters yield rather than spin so that a
+ * preempted combiner gets the processor back.
+ */
+
+enum slot_state {
+    SLOT_IDLE     = 0,
+    SLOT_PENDING  = 1, /* published, not applied yet */
+    SLOT_ACCEPTED = 2, /* apply returned TRUE */
+    SLOT_REFUSED  = 3, /* apply returned FALSE */
+};
+
+typedef struct slot {
+    long state;            /* slot_state; written with release, read with acquire */
+    void* requestPtr;
+    bool_t (*apply)(void* requestPtr);
+    combiner_stats_t stats;
+    char padding[64];      /* keep slots on separate lines */
+} slot_t;
+
+struct combiner {
+    long numThread;
+    slot_t* slots;
+    pthread_mutex_t lock;
+};
+
+
+/* =============================================================================
+ * combiner_alloc
+ * =============================================================================
+ */
+combiner_t* combiner_alloc (long numThread){
+    assert(numThread >= 1);
+
+    combiner_t* combinerPtr = (combiner_t*)malloc(sizeof(combiner_t));
+    if (combinerPtr == NULL) {
+        return NULL;
+    }
+    combinerPtr->numThread = numThread;
+    combinerPtr->slots = (slot_t*)calloc(numThread, sizeof(slot_t));
+    if (combinerPtr->slots == NULL) {
+        free(combinerPtr);
+        return NULL;
+    }
+    pthread_mutex_init(&combinerPtr->lock, NULL);
+
+    return combinerPtr;
+}
+
+
+/* =============================================================================
+ * combiner_free
+ * =============================================================================
+ */
+void combiner_free (combiner_t* combinerPtr){
+    pthread_mutex_destroy(&combinerPtr->lock);
+    free(combinerPtr->slots);
+    free(combinerPtr);
+}
+
+
+/* =============================================================================
+ * combine
+ * -- Applies every pending request; call with the lock held
+ * =============================================================================
+ */
+static void combine (combiner_t* combinerPtr, long id){
+    combiner_stats_t* statsPtr = &combinerPtr->slots[id].stats;
+    long numApplied = 0;
+    long s;
+    for (s = 0; s < COMBINER_MAX_SCAN; s++) {
+        long numFound = 0;
+        long t;
+        for (t = 0; t < combinerPtr->numThread; t++) {
+            slot_t* slotPtr = &combinerPtr->slots[t];
+            if (__atomic_load_n(&slotPtr->state, __ATOMIC_ACQUIRE) != SLOT_PENDING) {
+                continue;
+            }
+            bool_t isAccepted = slotPtr->apply(slotPtr->requestPtr);
+            __atomic_store_n(&slotPtr->state, (isAccepted ? SLOT_ACCEPTED : SLOT_REFUSED),
+                             __ATOMIC_RELEASE);
+            if (t != id) {
+                statsPtr->numAppliedOther++;
+            }
+            numFound++;
+        }
+        numApplied += numFound;
+        if (numFound == 0) {
+            break;
+        }
+    }
+    if (numApplied == 0) {
+        return; /* its own request was applied while it waited for the lock */
+    }
+    statsPtr->numPass++;
+    statsPtr->numApplied += numApplied;
+    if (numApplied > statsPtr->maxApplied) {
+        statsPtr->maxApplied = numApplied;
+    }
+}
+
+
+/* =============================================================================
+ * combiner_run
+ * =============================================================================
+ */
+bool_t combiner_run (combiner_t* combinerPtr, long id, void* requestPtr,
+                     bool_t (*apply)(void* requestPtr)){
+    assert(id >= 0 && id < combinerPtr->numThread);
+    slot_t* slotPtr = &combinerPtr->slots[id];
+    slotPtr->stats.numRequest++;
+    slotPtr->requestPtr = requestPtr;
+    slotPtr->apply = apply;
+    __atomic_store_n(&slotPtr->state, SLOT_PENDING, __ATOMIC_RELEASE);
+
+    long state;
+    while (TRUE) {
+        if (pthread_mutex_trylock(&combinerPtr->lock) == 0) {
+            combine(combinerPtr, id);
+            pthread_mutex_unlock(&combinerPtr->lock);
+        }
+        state = __atomic_load_n(&slotPtr->state, __ATOMIC_ACQUIRE);
+        if (state != SLOT_PENDING) {
+            break;
+        }
+        sched_yield();
+    }
+    __atomic_store_n(&slotPtr->state, SLOT_IDLE, __ATOMIC_RELAXED);
+
+    return ((state == SLOT_ACCEPTED) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * combiner_printStats
+ * =============================================================================
+ */
+void combiner_printStats (combiner_t* combinerPtr, FILE* file){
+    combiner_stats_t total;
+    memset(&total, 0, sizeof(combiner_stats_t));
+    long t;
+    for (t = 0; t < combinerPtr->numThread; t++) {
+        combiner_stats_t* statsPtr = &combinerPtr->slots[t].stats;
+        total.numRequest      += statsPtr->numRequest;
+        total.numPass         += statsPtr->numPass;
+        total.numApplied      += statsPtr->numApplied;
+        total.numAppliedOther += statsPtr->numAppliedOther;
+        if (statsPtr->maxApplied > total.maxApplied) {
+            total.maxApplied = statsPtr->maxApplied;
+        }
+    }
+    fprintf(file, "Combining       = %li requests in %li passes (%.2f per pass, at most %li)\n",
+            total.numRequest, total.numPass,
+            ((total.numPass > 0) ? ((double)total.numApplied / (double)total.numPass) : 0.0),
+            total.maxApplied);
+    fprintf(file, "Handoffs saved  = %li (requests applied by another thread's pass)\n",
+            total.numAppliedOther);
+    for (t = 0; t < combinerPtr->numThread; t++) {
+        combiner_stats_t* statsPtr = &combinerPtr->slots[t].stats;
+        fprintf(file, "  thread %-7li= %li requests, %li passes, %li applied for others\n",
+                t, statsPtr->numRequest, statsPtr->numPass, statsPtr->numAppliedOther);
+    }
+}
+
+
+/* =============================================================================
+ *
+ * End of combiner.c
+ *
+ * =============================================================================
+ */
@@ -0,0 +1,120 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * combiner.h
+ *
+ * =============================================================================
+ */
+
+
+#ifndef COMBINER_H
+#define COMBINER_H 1
+
+
+#include <stdio.h>
+#include "lib/types.h"
+
+enum combiner_config {
+    COMBINER_MAX_SCAN = 4, /* sweeps of the slots per pass while requests keep arriving */
+};
+
+typedef struct combiner combiner_t;
+
+typedef struct combiner_stats {
+    long numRequest;     /* requests the thread published */
+    long numPass;        /* combining passes the thread ran that applied something */
+    long numApplied;     /* requests applied in those passes, its own included */
+    long numAppliedOther; /* of those, requests other threads published */
+    long maxApplied;     /* most requests applied in one pass */
+} combiner_stats_t;
+
+
+/* =============================================================================
+ * combiner_alloc
+ * -- One publication slot per thread; threads are identified by the ids
+ *    workpool_join hands out
+ * =============================================================================
+ */
+combiner_t* combiner_alloc (long numThread);
+
+
+/* =============================================================================
+ * combiner_free
+ * =============================================================================
+ */
+void combiner_free (combiner_t* combinerPtr);
+
+
+/* =============================================================================
+ * combiner_run
+ * -- Publishes requestPtr in thread id's slot and returns once some thread,
+ *    possibly this one, has called apply(requestPtr) holding the combining
+ *    lock; returns what apply returned
+ * -- apply never runs concurrently with another apply of the same combiner
+ * =============================================================================
+ */
+bool_t combiner_run (combiner_t* combinerPtr, long id, void* requestPtr,
+                     bool_t (*apply)(void* requestPtr));
+
+
+/* =============================================================================
+ * combiner_printStats
+ * -- Call after the threads are joined
+ * =============================================================================
+ */
+void combiner_printStats (combiner_t* combinerPtr, FILE* file);
+
+
+#endif /* COMBINER_H */
+
+
+/* =============================================================================
+ *
+ * End of combiner.h
+ *
+ * =============================================================================
+ */
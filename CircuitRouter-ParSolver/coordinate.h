@@ -56,6 +56,7 @@
 
 
 #include "lib/types.h"
+#include "lib/vector.h"
 
 typedef struct coordinate {
     long x;
@@ -63,6 +64,13 @@ typedef struct coordinate {
     long z;
 } coordinate_t;
 
+enum coordinate_config {
+    COORDINATE_NUM_INLINE = 16
+};
+
+/* Coordinates held by value, e.g. the maze's walls and end points */
+VECTOR_DEFINE_TYPED(coordinatevector, coordinate_t, COORDINATE_NUM_INLINE)
+
 
 /* =============================================================================
  * coordinate_alloc
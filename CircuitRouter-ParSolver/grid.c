@@ -65,130 +65,163 @@ const unsigned long CACHE_LINE_SIZE = 32UL;
 
 
 /* =============================================================================
- * grid_alloc
+ * fillBorder
  * =============================================================================
  */
-grid_t* grid_alloc (long width, long height, long depth){
-    grid_t* gridPtr;
+static void fillBorder (grid_t* gridPtr){
+    long width  = gridPtr->width;
+    long height = gridPtr->height;
+    long depth  = gridPtr->depth;
+    grid_point_t* points = gridPtr->points;
+    long x;
+    long y;
+    long z;
 
-    gridPtr = (grid_t*)malloc(sizeof(grid_t));
-    if (gridPtr) {
-        gridPtr->width  = width;
-        gridPtr->height = height;
-        gridPtr->depth  = depth;
-        long n = width * height * depth;
-        long* points_unaligned = (long*)malloc(n * sizeof(long) + CACHE_LINE_SIZE);
-        assert(points_unaligned);
-        gridPtr->points_unaligned = points_unaligned;
-        gridPtr->points = (long*)((char*)(((unsigned long)points_unaligned
-                                          & ~(CACHE_LINE_SIZE-1)))
-                                  + CACHE_LINE_SIZE);
-        memset(gridPtr->points, GRID_POINT_EMPTY, (n * sizeof(long)));
+    /* Local coordinates, so this holds for windows too */
+    for (z = -1; z <= depth; z++) {
+        for (y = -1; y <= height; y++) {
+            if (z == -1 || z == depth || y == -1 || y == height) {
+                for (x = -1; x <= width; x++) {
+                    points[grid_getIndex(width, height, x, y, z)] = GRID_POINT_FULL;
+                }
+            } else {
+                points[grid_getIndex(width, height, -1,    y, z)] = GRID_POINT_FULL;
+                points[grid_getIndex(width, height, width, y, z)] = GRID_POINT_FULL;
+            }
+        }
     }
-
-    return gridPtr;
 }
 
+
 /* =============================================================================
- * grid_free
+ * setShape
  * =============================================================================
  */
-void grid_free (grid_t* gridPtr){
-    free(gridPtr->points_unaligned);
-    free(gridPtr);
+static void setShape (grid_t* gridPtr, long width, long height, long depth){
+    gridPtr->width  = width;
+    gridPtr->height = height;
+    gridPtr->depth  = depth;
+    gridPtr->numPoint = grid_getNumPoint(width, height, depth);
+    long steps[3] = { 1, (width + 2), (width + 2) * (height + 2) };
+    long a;
+    for (a = 0; a < 3; a++) {
+        gridPtr->neighborOffsets[GRID_MOVE_POSX + a] = +steps[a];
+        gridPtr->neighborOffsets[GRID_MOVE_NEGX + a] = -steps[a];
+    }
 }
 
 
 /* =============================================================================
- * grid_copy
+ * allocPoints
+ * -- A grid_t with a zeroed buffer of 'maxPoint' points and no shape
  * =============================================================================
  */
-void grid_copy (grid_t* dstGridPtr, grid_t* srcGridPtr){
-    assert(srcGridPtr->width  == dstGridPtr->width);
-    assert(srcGridPtr->height == dstGridPtr->height);
-    assert(srcGridPtr->depth  == dstGridPtr->depth);
+static grid_t* allocPoints (long maxPoint){
+    grid_t* gridPtr;
 
-    long n = srcGridPtr->width * srcGridPtr->height * srcGridPtr->depth;
-    memcpy(dstGridPtr->points, srcGridPtr->points, (n * sizeof(long)));
+    gridPtr = (grid_t*)malloc(sizeof(grid_t));
+    if (gridPtr) {
+        memset(gridPtr, 0, sizeof(grid_t));
+        gridPtr->maxPoint = maxPoint;
+        /* GRID_POINT_EMPTY is zero, so fresh (lazily zeroed) pages will do */
+        grid_point_t* points_unaligned = (grid_point_t*)calloc(1, maxPoint * sizeof(grid_point_t) + CACHE_LINE_SIZE);
+        assert(points_unaligned);
+        gridPtr->points_unaligned = points_unaligned;
+        gridPtr->points = (grid_point_t*)((char*)(((unsigned long)points_unaligned
+                                                  & ~(CACHE_LINE_SIZE-1)))
+                                          + CACHE_LINE_SIZE);
+    }
+
+    return gridPtr;
 }
 
 
 /* =============================================================================
- * grid_isPointValid
+ * grid_alloc
  * =============================================================================
  */
-bool_t grid_isPointValid (grid_t* gridPtr, long x, long y, long z){
-    if (x < 0 || x >= gridPtr->width  ||
-        y < 0 || y >= gridPtr->height ||
-        z < 0 || z >= gridPtr->depth)
-    {
-        return FALSE;
+grid_t* grid_alloc (long width, long height, long depth){
+    grid_t* gridPtr = allocPoints(grid_getNumPoint(width, height, depth));
+
+    if (gridPtr) {
+        setShape(gridPtr, width, height, depth);
+        fillBorder(gridPtr);
     }
 
-    return TRUE;
+    return gridPtr;
 }
 
 
 /* =============================================================================
- * grid_getPointRef
+ * grid_allocBuffer
  * =============================================================================
  */
-long* grid_getPointRef (grid_t* gridPtr, long x, long y, long z){
-    return &(gridPtr->points[(z * gridPtr->height + y) * gridPtr->width + x]);
+grid_t* grid_allocBuffer (long maxPoint){
+    return allocPoints(maxPoint);
 }
 
 
 /* =============================================================================
- * grid_getPointIndices
+ * grid_setWindow
  * =============================================================================
  */
-void grid_getPointIndices (grid_t* gridPtr, long* gridPointPtr, long* xPtr, long* yPtr, long* zPtr){
-    long height = gridPtr->height;
-    long width  = gridPtr->width;
-    long area = height * width;
-    long index3d = (gridPointPtr - gridPtr->points);
-    (*zPtr) = index3d / area;
-    long index2d = index3d % area;
-    (*yPtr) = index2d / width;
-    (*xPtr) = index2d % width;
-}
+bool_t grid_setWindow (grid_t* gridPtr, coordinate_t* minPtr, coordinate_t* maxPtr){
+    long width  = maxPtr->x - minPtr->x + 1;
+    long height = maxPtr->y - minPtr->y + 1;
+    long depth  = maxPtr->z - minPtr->z + 1;
 
+    if (grid_getNumPoint(width, height, depth) > gridPtr->maxPoint) {
+        return FALSE;
+    }
 
-/* =============================================================================
- * grid_getPoint
- * =============================================================================
- */
-long grid_getPoint (grid_t* gridPtr, long x, long y, long z){
-    return *grid_getPointRef(gridPtr, x, y, z);
+    setShape(gridPtr, width, height, depth);
+    gridPtr->origin = *minPtr;
+    fillBorder(gridPtr);
+
+    return TRUE;
 }
 
 
 /* =============================================================================
- * grid_isPointEmpty
+ * grid_free
  * =============================================================================
  */
-bool_t grid_isPointEmpty (grid_t* gridPtr, long x, long y, long z){
-    long value = grid_getPoint(gridPtr, x, y, z);
-    return ((value == GRID_POINT_EMPTY) ? TRUE : FALSE);
+void grid_free (grid_t* gridPtr){
+    free(gridPtr->points_unaligned);
+    free(gridPtr);
 }
 
 
 /* =============================================================================
- * grid_isPointFull
+ * grid_copy
  * =============================================================================
  */
-bool_t grid_isPointFull (grid_t* gridPtr, long x, long y, long z){
-    long value = grid_getPoint(gridPtr, x, y, z);
-    return ((value == GRID_POINT_FULL) ? TRUE : FALSE);
+void grid_copy (grid_t* dstGridPtr, grid_t* srcGridPtr){
+    assert(srcGridPtr->width  == dstGridPtr->width);
+    assert(srcGridPtr->height == dstGridPtr->height);
+    assert(srcGridPtr->depth  == dstGridPtr->depth);
+
+    memcpy(dstGridPtr->points, srcGridPtr->points, (srcGridPtr->numPoint * sizeof(grid_point_t)));
 }
 
 
 /* =============================================================================
- * grid_setPoint
+ * grid_getPointIndices
  * =============================================================================
  */
-void grid_setPoint (grid_t* gridPtr, long x, long y, long z, long value){
-    (*grid_getPointRef(gridPtr, x, y, z)) = value;
+void grid_getPointIndices (grid_t* gridPtr, grid_point_t* gridPointPtr, long* xPtr, long* yPtr, long* zPtr){
+    long height = gridPtr->height + 2;
+    long width  = gridPtr->width  + 2;
+    long index3d = (gridPointPtr - gridPtr->points);
+    long area = height * width;
+    (*zPtr) = index3d / area;
+    long index2d = index3d % area;
+    (*yPtr) = index2d / width;
+    (*xPtr) = index2d % width;
+    /* Undo the border, then the window's offset */
+    (*xPtr) += gridPtr->origin.x - 1;
+    (*yPtr) += gridPtr->origin.y - 1;
+    (*zPtr) += gridPtr->origin.z - 1;
 }
 
 
@@ -196,12 +229,12 @@ void grid_setPoint (grid_t* gridPtr, long x, long y, long z, long value){
  * grid_addPath
  * =============================================================================
  */
-void grid_addPath (grid_t* gridPtr, vector_t* pointVectorPtr){
+void grid_addPath (grid_t* gridPtr, coordinatevector_t* pointVectorPtr){
     long i;
-    long n = vector_getSize(pointVectorPtr);
+    long n = coordinatevector_getSize(pointVectorPtr);
 
     for (i = 0; i < n; i++) {
-        coordinate_t* coordinatePtr = (coordinate_t*)vector_at(pointVectorPtr, i);
+        coordinate_t* coordinatePtr = coordinatevector_at(pointVectorPtr, i);
         long x = coordinatePtr->x;
         long y = coordinatePtr->y;
         long z = coordinatePtr->z;
@@ -219,7 +252,7 @@ void grid_addPath_Ptr (grid_t* gridPtr, vector_t* pointVectorPtr){
     long n = vector_getSize(pointVectorPtr);
 
     for (i = 1; i < (n-1); i++) {
-        long* gridPointPtr = (long*)vector_at(pointVectorPtr, i);
+        grid_point_t* gridPointPtr = (grid_point_t*)vector_at(pointVectorPtr, i);
         *gridPointPtr = GRID_POINT_FULL;
     }
 }
@@ -240,7 +273,7 @@ void grid_print (grid_t* gridPtr, FILE* file){
         for (x = 0; x < width; x++) {
             long y;
             for (y = 0; y < height; y++) {
-                fprintf(file, "%4li", *grid_getPointRef(gridPtr, x, y, z));
+                fprintf(file, "%4li", (long)*grid_getPointRef(gridPtr, x, y, z));
             }
             fputs("", file);
         }
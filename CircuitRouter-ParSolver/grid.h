@@ -54,100 +54,243 @@
 #ifndef GRID_H
 #define GRID_H 1
 
+#include <stdint.h>
 #include <stdio.h>
+#include "coordinate.h"
 #include "lib/types.h"
 #include "lib/vector.h"
 
+/*
+ * Width of a grid point, chosen at build time (make GRID_POINT_BITS=16).
+ * Private grids hold distances, so narrower points suit smaller jobs, such
+ * as runs confined to small search windows (-w). An expansion whose labels
+ * would outgrow GRID_POINT_MAX stops, and the router searches that window
+ * again with labels as wide as a long.
+ */
+#ifndef GRID_POINT_BITS
+#  define GRID_POINT_BITS 32
+#endif
+
+#if GRID_POINT_BITS == 16
+typedef int16_t grid_point_t;
+#  define GRID_POINT_MAX  INT16_MAX
+#elif GRID_POINT_BITS == 32
+typedef int32_t grid_point_t;
+#  define GRID_POINT_MAX  INT32_MAX
+#elif GRID_POINT_BITS == 64
+typedef int64_t grid_point_t;
+#  define GRID_POINT_MAX  INT64_MAX
+#else
+#  error "GRID_POINT_BITS must be 16, 32 or 64"
+#endif
+
+/*
+ * Points are stored in rows of x, then rows of y, then layers, surrounded by
+ * a border one point thick that is GRID_POINT_FULL for the life of the
+ * grid, so a neighbor never needs a bounds test, only a step by
+ * grid_getNeighborIndex.
+ *
+ * A grid may also cover just a box of a larger one (see grid_setWindow).
+ * Coordinates passed to and returned by the functions below are then still
+ * those of the larger grid; only indices are the window's own.
+ */
+typedef enum grid_move {
+    GRID_MOVE_POSX = 0,
+    GRID_MOVE_POSY = 1,
+    GRID_MOVE_POSZ = 2,
+    GRID_MOVE_NEGX = 3,
+    GRID_MOVE_NEGY = 4,
+    GRID_MOVE_NEGZ = 5,
+    GRID_NUM_MOVE
+} grid_move_t;
 
 typedef struct grid {
     long width;
     long height;
     long depth;
-    long* points;
-    long* points_unaligned;
+    coordinate_t origin; /* coordinates of point (0, 0, 0); zero unless a window */
+    long numPoint;       /* including the border */
+    long maxPoint;       /* what the point buffer holds */
+    long neighborOffsets[GRID_NUM_MOVE];
+    grid_point_t* points;
+    grid_point_t* points_unaligned;
 } grid_t;
 
+/*
+ * An empty grid is all zero bytes. Distance d from a source is stored as
+ * GRID_POINT_ORIGIN + d.
+ */
 enum {
-    GRID_POINT_FULL  = -2L,
-    GRID_POINT_EMPTY = -1L
+    GRID_POINT_FULL   = -1L,
+    GRID_POINT_EMPTY  = 0L,
+    GRID_POINT_ORIGIN = 1L
 };
 
 
 /* =============================================================================
- * grid_alloc
+ * grid_getIndex
+ * -- Position of point (x, y, z) of a width x height grid in the layout;
+ *    -1 and width (height, depth) address the border
  * =============================================================================
  */
-grid_t* grid_alloc (long width, long height, long depth);
+static inline long grid_getIndex (long width, long height, long x, long y, long z){
+    long padWidth  = width  + 2;
+    long padHeight = height + 2;
+    long px = x + 1;
+    long py = y + 1;
+    long pz = z + 1;
+    return ((pz * padHeight + py) * padWidth + px);
+}
 
 
 /* =============================================================================
- * grid_free
+ * grid_getNumPoint
+ * -- Points a width x height x depth grid occupies in the layout
  * =============================================================================
  */
-void grid_free (grid_t* gridPtr);
+static inline long grid_getNumPoint (long width, long height, long depth){
+    long padWidth  = width  + 2;
+    long padHeight = height + 2;
+    long padDepth  = depth  + 2;
+    return (padWidth * padHeight * padDepth);
+}
 
 
 /* =============================================================================
- * grid_copy
+ * grid_getNeighborIndex
+ * -- Index of the point one step from 'index' in direction 'move'; from a
+ *    point of the grid this is at worst a border point
  * =============================================================================
  */
-void grid_copy (grid_t* dstGridPtr, grid_t* srcGridPtr);
+static inline long grid_getNeighborIndex (grid_t* gridPtr, long index, grid_move_t move){
+    return (index + gridPtr->neighborOffsets[move]);
+}
 
 
 /* =============================================================================
  * grid_isPointValid
  * =============================================================================
  */
-bool_t grid_isPointValid (grid_t* gridPtr, long x, long y, long z);
+static inline bool_t grid_isPointValid (grid_t* gridPtr, long x, long y, long z){
+    x -= gridPtr->origin.x;
+    y -= gridPtr->origin.y;
+    z -= gridPtr->origin.z;
+    if (x < 0 || x >= gridPtr->width  ||
+        y < 0 || y >= gridPtr->height ||
+        z < 0 || z >= gridPtr->depth)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
 
 
 /* =============================================================================
  * grid_getPointRef
+ * -- Also valid for points of the border
  * =============================================================================
  */
-long* grid_getPointRef (grid_t* gridPtr, long x, long y, long z);
+static inline grid_point_t* grid_getPointRef (grid_t* gridPtr, long x, long y, long z){
+    return &(gridPtr->points[grid_getIndex(gridPtr->width, gridPtr->height,
+                                           (x - gridPtr->origin.x),
+                                           (y - gridPtr->origin.y),
+                                           (z - gridPtr->origin.z))]);
+}
 
 
 /* =============================================================================
- * grid_getPointIndices
+ * grid_getPoint
  * =============================================================================
  */
-void grid_getPointIndices (grid_t* gridPtr, long* gridPointPtr, long* xPtr, long* yPtr, long* zPtr);
+static inline long grid_getPoint (grid_t* gridPtr, long x, long y, long z){
+    return *grid_getPointRef(gridPtr, x, y, z);
+}
 
 
 /* =============================================================================
- * grid_getPoint
+ * grid_setPoint
  * =============================================================================
  */
-long grid_getPoint (grid_t* gridPtr, long x, long y, long z);
+static inline void grid_setPoint (grid_t* gridPtr, long x, long y, long z, long value){
+    (*grid_getPointRef(gridPtr, x, y, z)) = value;
+}
 
 
 /* =============================================================================
  * grid_isPointEmpty
  * =============================================================================
  */
-bool_t grid_isPointEmpty (grid_t* gridPtr, long x, long y, long z);
+static inline bool_t grid_isPointEmpty (grid_t* gridPtr, long x, long y, long z){
+    long value = grid_getPoint(gridPtr, x, y, z);
+    return ((value == GRID_POINT_EMPTY) ? TRUE : FALSE);
+}
 
 
 /* =============================================================================
  * grid_isPointFull
  * =============================================================================
  */
-bool_t grid_isPointFull (grid_t* gridPtr, long x, long y, long z);
+static inline bool_t grid_isPointFull (grid_t* gridPtr, long x, long y, long z){
+    long value = grid_getPoint(gridPtr, x, y, z);
+    return ((value == GRID_POINT_FULL) ? TRUE : FALSE);
+}
 
 
 /* =============================================================================
- * grid_setPoint
+ * grid_alloc
+ * =============================================================================
+ */
+grid_t* grid_alloc (long width, long height, long depth);
+
+
+/* =============================================================================
+ * grid_allocBuffer
+ * -- A grid with room for maxPoint points and no shape yet; give it one with
+ *    grid_setWindow before use
+ * =============================================================================
+ */
+grid_t* grid_allocBuffer (long maxPoint);
+
+
+/* =============================================================================
+ * grid_setWindow
+ * -- Reshapes the grid to cover the box [minPtr, maxPtr] of a larger grid,
+ *    reusing its point buffer, and fills the border; the points inside are
+ *    left as they are, so callers rebuild them
+ * -- Returns FALSE, leaving the grid as it was, if the box needs more than
+ *    maxPoint points
+ * =============================================================================
+ */
+bool_t grid_setWindow (grid_t* gridPtr, coordinate_t* minPtr, coordinate_t* maxPtr);
+
+
+/* =============================================================================
+ * grid_free
+ * =============================================================================
+ */
+void grid_free (grid_t* gridPtr);
+
+
+/* =============================================================================
+ * grid_copy
+ * =============================================================================
+ */
+void grid_copy (grid_t* dstGridPtr, grid_t* srcGridPtr);
+
+
+/* =============================================================================
+ * grid_getPointIndices
  * =============================================================================
  */
-void grid_setPoint (grid_t* gridPtr, long x, long y, long z, long value);
+void grid_getPointIndices (grid_t* gridPtr, grid_point_t* gridPointPtr, long* xPtr, long* yPtr, long* zPtr);
 
 
 /* =============================================================================
  * grid_addPath
  * =============================================================================
  */
-void grid_addPath (grid_t* gridPtr, vector_t* pointVectorPtr);
+void grid_addPath (grid_t* gridPtr, coordinatevector_t* pointVectorPtr);
 
 
 /* =============================================================================
@@ -59,6 +59,8 @@
 #include "grid.h"
 #include "lib/list.h"
 #include "maze.h"
+#include "occupancy.h"
+#include "path.h"
 #include "lib/queue.h"
 #include "lib/pair.h"
 #include "lib/types.h"
@@ -75,10 +77,11 @@ maze_t* maze_alloc (){
     mazePtr = (maze_t*)malloc(sizeof(maze_t));
     if (mazePtr) {
         mazePtr->gridPtr = NULL;
+        mazePtr->occupancyPtr = NULL;
         mazePtr->workQueuePtr = queue_alloc(1024);
-        mazePtr->wallVectorPtr = vector_alloc(1);
-        mazePtr->srcVectorPtr = vector_alloc(1);
-        mazePtr->dstVectorPtr = vector_alloc(1);
+        mazePtr->wallVectorPtr = coordinatevector_alloc(1);
+        mazePtr->srcVectorPtr = coordinatevector_alloc(1);
+        mazePtr->dstVectorPtr = coordinatevector_alloc(1);
         assert(mazePtr->workQueuePtr &&
                mazePtr->wallVectorPtr &&
                mazePtr->srcVectorPtr &&
@@ -96,28 +99,15 @@ void maze_free (maze_t* mazePtr){
     if (mazePtr->gridPtr != NULL) {
         grid_free(mazePtr->gridPtr);
     }
+    if (mazePtr->occupancyPtr != NULL) {
+        occupancy_free(mazePtr->occupancyPtr);
+    }
     assert(queue_isEmpty(mazePtr->workQueuePtr));
     queue_free(mazePtr->workQueuePtr);
 
-    coordinate_t* coord;
-
-    while((coord = vector_popBack(mazePtr->wallVectorPtr))) {
-        coordinate_free(coord);
-    }
-    assert(vector_getSize(mazePtr->wallVectorPtr) == 0);
-    vector_free(mazePtr->wallVectorPtr);
-
-    while((coord = vector_popBack(mazePtr->srcVectorPtr))) {
-        coordinate_free(coord);
-    }
-    assert(vector_getSize(mazePtr->srcVectorPtr) == 0);
-    vector_free(mazePtr->srcVectorPtr);
-
-    while((coord = vector_popBack(mazePtr->dstVectorPtr))) {
-        coordinate_free(coord);
-    }
-    assert(vector_getSize(mazePtr->dstVectorPtr) == 0);
-    vector_free(mazePtr->dstVectorPtr);
+    coordinatevector_free(mazePtr->wallVectorPtr);
+    coordinatevector_free(mazePtr->srcVectorPtr);
+    coordinatevector_free(mazePtr->dstVectorPtr);
 
     free(mazePtr);
 }
@@ -127,11 +117,11 @@ void maze_free (maze_t* mazePtr){
  * addToGrid
  * =============================================================================
  */
-static void addToGrid (grid_t* gridPtr, vector_t* vectorPtr, char* type){
+static void addToGrid (grid_t* gridPtr, coordinatevector_t* vectorPtr, char* type){
     long i;
-    long n = vector_getSize(vectorPtr);
+    long n = coordinatevector_getSize(vectorPtr);
     for (i = 0; i < n; i++) {
-        coordinate_t* coordinatePtr = (coordinate_t*)vector_at(vectorPtr, i);
+        coordinate_t* coordinatePtr = coordinatevector_at(vectorPtr, i);
         if (!grid_isPointValid(gridPtr,
                                coordinatePtr->x,
                                coordinatePtr->y,
@@ -167,10 +157,28 @@ long maze_read (maze_t* mazePtr, char* filename){
     if (file == NULL)
         exit(-1);
 
-    list_t* workListPtr = list_alloc(&coordinate_comparePair);
-    vector_t* wallVectorPtr = mazePtr->wallVectorPtr;
-    vector_t* srcVectorPtr = mazePtr->srcVectorPtr;
-    vector_t* dstVectorPtr = mazePtr->dstVectorPtr;
+    coordinatevector_t* wallVectorPtr = mazePtr->wallVectorPtr;
+    coordinatevector_t* srcVectorPtr = mazePtr->srcVectorPtr;
+    coordinatevector_t* dstVectorPtr = mazePtr->dstVectorPtr;
+
+    /*
+     * Count paths and walls first so each vector is allocated once, at its
+     * final size
+     */
+    long numPath = 0;
+    long numWall = 0;
+    while (fgets(line, sizeof(line), file)) {
+        char code;
+        if (sscanf(line, " %c", &code) == 1) {
+            numPath += (code == 'p');
+            numWall += (code == 'w');
+        }
+    }
+    rewind(file);
+    bool_t status = (coordinatevector_reserve(wallVectorPtr, numWall) &&
+                     coordinatevector_reserve(srcVectorPtr, numPath) &&
+                     coordinatevector_reserve(dstVectorPtr, numPath));
+    assert(status);
 
     while (fgets(line, sizeof(line), file)) {
 
@@ -207,27 +215,21 @@ long maze_read (maze_t* mazePtr, char* filename){
                 if (numToken != 7) {
                     goto PARSE_ERROR;
                 }
-                coordinate_t* srcPtr = coordinate_alloc(x1, y1, z1);
-                coordinate_t* dstPtr = coordinate_alloc(x2, y2, z2);
-                assert(srcPtr);
-                assert(dstPtr);
-                if (coordinate_isEqual(srcPtr, dstPtr)) {
+                coordinate_t src = {x1, y1, z1};
+                coordinate_t dst = {x2, y2, z2};
+                if (coordinate_isEqual(&src, &dst)) {
                     goto PARSE_ERROR;
                 }
-                pair_t* coordinatePairPtr = pair_alloc(srcPtr, dstPtr);
-                assert(coordinatePairPtr);
-                bool_t status = list_insert(workListPtr, (void*)coordinatePairPtr);
-                assert(status == TRUE);
-                vector_pushBack(srcVectorPtr, (void*)srcPtr);
-                vector_pushBack(dstVectorPtr, (void*)dstPtr);
+                coordinatevector_pushBack(srcVectorPtr, src);
+                coordinatevector_pushBack(dstVectorPtr, dst);
                 break;
             }
             case 'w': { /* walls (format: w x y z) */
                 if (numToken != 4) {
                     goto PARSE_ERROR;
                 }
-                coordinate_t* wallPtr = coordinate_alloc(x1, y1, z1);
-                vector_pushBack(wallVectorPtr, (void*)wallPtr);
+                coordinate_t wall = {x1, y1, z1};
+                coordinatevector_pushBack(wallVectorPtr, wall);
                 break;
             }
             PARSE_ERROR:
@@ -243,6 +245,21 @@ long maze_read (maze_t* mazePtr, char* filename){
     /*closes the  input file*/
     fclose(file);
 
+    /*
+     * Pair up end points; the vectors are complete, so the pairs can point
+     * into them
+     */
+    list_t* workListPtr = list_alloc(&coordinate_comparePair);
+    assert(workListPtr);
+    long i;
+    for (i = 0; i < coordinatevector_getSize(srcVectorPtr); i++) {
+        pair_t* coordinatePairPtr = pair_alloc(coordinatevector_at(srcVectorPtr, i),
+                                               coordinatevector_at(dstVectorPtr, i));
+        assert(coordinatePairPtr);
+        status = list_insert(workListPtr, (void*)coordinatePairPtr);
+        assert(status == TRUE);
+    }
+
     /*creates a .res (and .res.old) file*/
     strcat(filename, ".res");
     char* fileOld = (char*) malloc((strlen(filename)+strlen(".old")+1)*sizeof(char));
@@ -268,6 +285,8 @@ long maze_read (maze_t* mazePtr, char* filename){
     addToGrid(gridPtr, wallVectorPtr, "wall");
     addToGrid(gridPtr, srcVectorPtr,  "source");
     addToGrid(gridPtr, dstVectorPtr,  "destination");
+    mazePtr->occupancyPtr = occupancy_alloc(gridPtr, coordinatevector_getSize(srcVectorPtr));
+    assert(mazePtr->occupancyPtr);
     fprintf(file, "Maze dimensions = %li x %li x %li\n", width, height, depth);
     fprintf(file, "Paths to route  = +%li\n", list_getSize(workListPtr));
 
@@ -285,9 +304,57 @@ long maze_read (maze_t* mazePtr, char* filename){
     }
     list_free(workListPtr);
 
-    return vector_getSize(srcVectorPtr);
+    return coordinatevector_getSize(srcVectorPtr);
 }
 
+/*
+ * End points are shared by the paths that start or end there, so
+ * maze_checkPaths marks them with a value no path id or wall can take
+ */
+#define MAZE_POINT_ENDPOINT  (GRID_POINT_FULL - 1)
+
+/*
+ * Values the routed maze is printed with, as the .res format has always had
+ * them: walls -2, free points -1, end points 0 and path ids from 1
+ */
+enum maze_print_value {
+    MAZE_PRINT_WALL     = -2,
+    MAZE_PRINT_EMPTY    = -1,
+    MAZE_PRINT_ENDPOINT = 0,
+};
+
+
+/* =============================================================================
+ * printMaze
+ * -- Same layout as grid_print, with the sentinels of testGridPtr mapped back
+ *    to the printed values
+ * =============================================================================
+ */
+static void printMaze (grid_t* testGridPtr, FILE* file){
+    long z;
+    for (z = 0; z < testGridPtr->depth; z++) {
+        fprintf(file, "[z = %li]\n", z);
+        long x;
+        for (x = 0; x < testGridPtr->width; x++) {
+            long y;
+            for (y = 0; y < testGridPtr->height; y++) {
+                long value = (long)*grid_getPointRef(testGridPtr, x, y, z);
+                if (value == GRID_POINT_FULL) {
+                    value = MAZE_PRINT_WALL;
+                } else if (value == GRID_POINT_EMPTY) {
+                    value = MAZE_PRINT_EMPTY;
+                } else if (value == MAZE_POINT_ENDPOINT) {
+                    value = MAZE_PRINT_ENDPOINT;
+                }
+                fprintf(file, "%4li", value);
+            }
+            fputs("", file);
+        }
+        fputs("", file);
+    }
+}
+
+
 /* =============================================================================
  * maze_checkPaths
  * =============================================================================
@@ -304,19 +371,19 @@ bool_t maze_checkPaths (maze_t* mazePtr, list_t* pathVectorListPtr, bool_t doPri
     grid_addPath(testGridPtr, mazePtr->wallVectorPtr);
 
     /* Mark sources */
-    vector_t* srcVectorPtr = mazePtr->srcVectorPtr;
-    long numSrc = vector_getSize(srcVectorPtr);
+    coordinatevector_t* srcVectorPtr = mazePtr->srcVectorPtr;
+    long numSrc = coordinatevector_getSize(srcVectorPtr);
     for (i = 0; i < numSrc; i++) {
-        coordinate_t* srcPtr = (coordinate_t*)vector_at(srcVectorPtr, i);
-        grid_setPoint(testGridPtr, srcPtr->x, srcPtr->y, srcPtr->z, 0);
+        coordinate_t* srcPtr = coordinatevector_at(srcVectorPtr, i);
+        grid_setPoint(testGridPtr, srcPtr->x, srcPtr->y, srcPtr->z, MAZE_POINT_ENDPOINT);
     }
 
     /* Mark destinations */
-    vector_t* dstVectorPtr = mazePtr->dstVectorPtr;
-    long numDst = vector_getSize(dstVectorPtr);
+    coordinatevector_t* dstVectorPtr = mazePtr->dstVectorPtr;
+    long numDst = coordinatevector_getSize(dstVectorPtr);
     for (i = 0; i < numDst; i++) {
-        coordinate_t* dstPtr = (coordinate_t*)vector_at(dstVectorPtr, i);
-        grid_setPoint(testGridPtr, dstPtr->x, dstPtr->y, dstPtr->z, 0);
+        coordinate_t* dstPtr = coordinatevector_at(dstVectorPtr, i);
+        grid_setPoint(testGridPtr, dstPtr->x, dstPtr->y, dstPtr->z, MAZE_POINT_ENDPOINT);
     }
 
     /* Make sure path is contiguous and does not overlap */
@@ -329,52 +396,44 @@ bool_t maze_checkPaths (maze_t* mazePtr, list_t* pathVectorListPtr, bool_t doPri
         long i;
         for (i = 0; i < numPath; i++) {
             id++;
-            vector_t* pointVectorPtr = (vector_t*)vector_at(pathVectorPtr, i);
+            path_t* pathPtr = (path_t*)vector_at(pathVectorPtr, i);
+            grid_point_t* testPoints = testGridPtr->points;
+            long numPoint = path_getNumPoint(pathPtr);
+            path_iter_t pathIt;
+            path_iter_reset(&pathIt, pathPtr);
             /* Check start */
-            long* prevGridPointPtr = (long*)vector_at(pointVectorPtr, 0);
-            long x;
-            long y;
-            long z;
-            grid_getPointIndices(gridPtr, prevGridPointPtr, &x, &y, &z);
-            if (grid_getPoint(testGridPtr, x, y, z) != 0) {
+            path_iter_next(&pathIt, testGridPtr, pathPtr);
+            if (!grid_isPointValid(testGridPtr, pathIt.coordinate.x, pathIt.coordinate.y, pathIt.coordinate.z) ||
+                testPoints[pathIt.index] != MAZE_POINT_ENDPOINT)
+            {
                 grid_free(testGridPtr);
                 return FALSE;
             }
-            coordinate_t prevCoordinate;
-            grid_getPointIndices(gridPtr,
-                                 prevGridPointPtr,
-                                 &prevCoordinate.x,
-                                 &prevCoordinate.y,
-                                 &prevCoordinate.z);
-            long numPoint = vector_getSize(pointVectorPtr);
-            long j;
-            for (j = 1; j < (numPoint-1); j++) { /* no need to check endpoints */
-                long* currGridPointPtr = (long*)vector_at(pointVectorPtr, j);
-                coordinate_t currCoordinate;
-                grid_getPointIndices(gridPtr,
-                                     currGridPointPtr,
-                                     &currCoordinate.x,
-                                     &currCoordinate.y,
-                                     &currCoordinate.z);
-                if (!coordinate_areAdjacent(&currCoordinate, &prevCoordinate)) {
+            coordinate_t prev = pathIt.coordinate;
+            while (path_iter_hasNext(&pathIt, pathPtr)) {
+                path_iter_next(&pathIt, testGridPtr, pathPtr);
+                coordinate_t* currPtr = &pathIt.coordinate;
+                /* Each step is one grid move, and its index agrees with it */
+                if (!grid_isPointValid(testGridPtr, currPtr->x, currPtr->y, currPtr->z) ||
+                    !coordinate_areAdjacent(currPtr, &prev) ||
+                    &testPoints[pathIt.index] != grid_getPointRef(testGridPtr, currPtr->x, currPtr->y, currPtr->z))
+                {
                     grid_free(testGridPtr);
                     return FALSE;
                 }
-                prevCoordinate = currCoordinate;
-                long x = currCoordinate.x;
-                long y = currCoordinate.y;
-                long z = currCoordinate.z;
-                if (grid_getPoint(testGridPtr, x, y, z) != GRID_POINT_EMPTY) {
+                prev = *currPtr;
+                if (pathIt.pointNum == numPoint) {
+                    break; /* no need to check endpoints */
+                }
+                if (testPoints[pathIt.index] != GRID_POINT_EMPTY) {
                     grid_free(testGridPtr);
                     return FALSE;
                 } else {
-                    grid_setPoint(testGridPtr, x, y, z, id);
+                    testPoints[pathIt.index] = id;
                 }
             }
             /* Check end */
-            long* lastGridPointPtr = (long*)vector_at(pointVectorPtr, j);
-            grid_getPointIndices(gridPtr, lastGridPointPtr, &x, &y, &z);
-            if (grid_getPoint(testGridPtr, x, y, z) != 0) {
+            if (numPoint < 2 || testPoints[pathIt.index] != MAZE_POINT_ENDPOINT) {
                 grid_free(testGridPtr);
                 return FALSE;
             }
@@ -387,7 +446,7 @@ bool_t maze_checkPaths (maze_t* mazePtr, list_t* pathVectorListPtr, bool_t doPri
         exit(-1);
     else if (doPrintPaths) {
         fputs("\nRouted Maze:", file);
-        grid_print(testGridPtr, file);
+        printMaze(testGridPtr, file);
     }
     fclose(file);
 
@@ -58,17 +58,19 @@
 #include "coordinate.h"
 #include "grid.h"
 #include "lib/list.h"
+#include "occupancy.h"
 #include "lib/pair.h"
 #include "lib/queue.h"
 #include "lib/types.h"
 #include "lib/vector.h"
 
 typedef struct maze {
-    grid_t* gridPtr;
-    queue_t* workQueuePtr;   /* contains source/destination pairs to route */
-    vector_t* wallVectorPtr; /* obstacles */
-    vector_t* srcVectorPtr;  /* sources */
-    vector_t* dstVectorPtr;  /* destinations */
+    grid_t* gridPtr;          /* the maze as read; paths reference its points */
+    occupancy_t* occupancyPtr; /* shared by the router threads */
+    queue_t* workQueuePtr;   /* source/destination pairs to route, longest first */
+    coordinatevector_t* wallVectorPtr; /* obstacles */
+    coordinatevector_t* srcVectorPtr;  /* sources; the work queue points into it */
+    coordinatevector_t* dstVectorPtr;  /* destinations; likewise */
 } maze_t;
 
 
@@ -96,6 +98,7 @@ long maze_read (maze_t* mazePtr, char* filename);
 
 /* =============================================================================
  * maze_checkPaths
+ * -- pathListPtr holds a vector of path_t pointers per router thread
  * =============================================================================
  */
 bool_t maze_checkPaths (maze_t* mazePtr, list_t* pathListPtr, bool_t doPrintPaths, char* filename);
@@ -0,0 +1,563 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * multiwave.c
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "coordinate.h"
+#include "grid.h"
+#include "lib/types.h"
+#include "multiwave.h"
+#include "occupancy.h"
+#include "path.h"
+
+
+/*
+ * Multi-net breadth-first expansion.
+ *
+ * Every point holds a record of 64-bit words, net i in bit i of each: 'seen'
+ * for the nets that labeled it (blocked points are seen by every net except
+ * the one ending there), one frontier per wave of the last zWave waves, and
+ * the arrival wave of each net modulo 2 * zWave + 1 in a few bit planes.
+ * Each net is confined to a box: points outside it are blocked for that net
+ * alone. Blocked points have their nets' plane bits set, which is no
+ * arrival modulo an odd modulus, so a traceback never mistakes one for a
+ * labeled neighbor. The
+ * record keeps a point's words on one cache line. Only the points listed in
+ * a frontier are visited, and one word operation advances all nets that
+ * share a point.
+ *
+ * Neighbors differ in distance by at most one move, so the modulo is enough
+ * for a traceback to recognize the neighbor one move closer to the source.
+ * Arrays carry a blocked border, so neighbors need no bounds test.
+ */
+
+enum multiwave_list_config {
+    MULTIWAVE_LIST_INIT_CAPACITY = 1024,
+};
+
+typedef struct index_list {
+    long* elements;
+    long size;
+    long capacity;
+} index_list_t;
+
+struct multiwave {
+    long width;           /* grid size, without the border */
+    long height;
+    long depth;
+    long padWidth;        /* width + 2 */
+    long padArea;         /* padWidth * (height + 2) */
+    long numPoint;        /* padded volume */
+    long zWave;           /* zCost / xCost */
+    long numFront;        /* zWave + 1 */
+    long modulus;         /* 2 * zWave + 1 */
+    long numPlane;        /* bits of modulus - 1 */
+    long numWord;         /* words per point: seen, frontiers, planes */
+    uint64_t* words;
+    index_list_t* lists;  /* points set in frontier w % numFront */
+    uint64_t* rowWords;   /* one grid row of occupancy, being loaded */
+    uint64_t* columnMasks; /* per x, the nets whose box spans it */
+    long srcIndex[MULTIWAVE_NUM_LANE];
+    long dstIndex[MULTIWAVE_NUM_LANE];
+    long distance[MULTIWAVE_NUM_LANE]; /* in waves; -1 if not reached */
+};
+
+
+/*
+ * Words of point 'index'
+ */
+#define SEEN(m, index)      ((m)->words[(index) * (m)->numWord])
+#define FRONT(m, f, index)  ((m)->words[(index) * (m)->numWord + 1 + (f)])
+#define PLANE(m, p, index)  ((m)->words[(index) * (m)->numWord + 1 + (m)->numFront + (p)])
+
+
+/* =============================================================================
+ * pushIndex
+ * =============================================================================
+ */
+static inline void pushIndex (index_list_t* listPtr, long index){
+    if (listPtr->size == listPtr->capacity) {
+        long newCapacity = 2 * listPtr->capacity;
+        long* newElements = (long*)realloc(listPtr->elements, newCapacity * sizeof(long));
+        assert(newElements);
+        listPtr->elements = newElements;
+        listPtr->capacity = newCapacity;
+    }
+    listPtr->elements[listPtr->size++] = index;
+}
+
+
+/* =============================================================================
+ * getIndex
+ * =============================================================================
+ */
+static inline long getIndex (multiwave_t* multiwavePtr, coordinate_t* coordinatePtr){
+    return ((coordinatePtr->z + 1) * multiwavePtr->padArea +
+            (coordinatePtr->y + 1) * multiwavePtr->padWidth +
+            (coordinatePtr->x + 1));
+}
+
+
+/* =============================================================================
+ * getGridPointRef
+ * -- Returns NULL for points of the border
+ * =============================================================================
+ */
+static inline grid_point_t* getGridPointRef (multiwave_t* multiwavePtr, grid_t* gridPtr, long index){
+    long x = (index % multiwavePtr->padWidth) - 1;
+    long y = ((index % multiwavePtr->padArea) / multiwavePtr->padWidth) - 1;
+    long z = (index / multiwavePtr->padArea) - 1;
+    if (x < 0 || x >= multiwavePtr->width ||
+        y < 0 || y >= multiwavePtr->height ||
+        z < 0 || z >= multiwavePtr->depth)
+    {
+        return NULL;
+    }
+    return grid_getPointRef(gridPtr, x, y, z);
+}
+
+
+/* =============================================================================
+ * multiwave_isSupported
+ * -- TRUE if xCost == yCost >= 1 and zCost is a multiple of it
+ * =============================================================================
+ */
+bool_t multiwave_isSupported (long xCost, long yCost, long zCost){
+    return ((xCost >= 1 && yCost == xCost && zCost >= xCost && (zCost % xCost) == 0) ?
+            TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * multiwave_alloc
+ * -- Sized for grids of width x height x depth; costs must satisfy
+ *    multiwave_isSupported
+ * =============================================================================
+ */
+multiwave_t* multiwave_alloc (long width, long height, long depth, long xCost, long yCost, long zCost){
+    multiwave_t* multiwavePtr;
+
+    assert(multiwave_isSupported(xCost, yCost, zCost));
+
+    multiwavePtr = (multiwave_t*)malloc(sizeof(multiwave_t));
+    if (multiwavePtr) {
+        multiwavePtr->width = width;
+        multiwavePtr->height = height;
+        multiwavePtr->depth = depth;
+        multiwavePtr->padWidth = width + 2;
+        multiwavePtr->padArea = multiwavePtr->padWidth * (height + 2);
+        multiwavePtr->numPoint = multiwavePtr->padArea * (depth + 2);
+        multiwavePtr->zWave = zCost / xCost;
+        multiwavePtr->numFront = multiwavePtr->zWave + 1;
+        multiwavePtr->modulus = 2 * multiwavePtr->zWave + 1;
+        long numPlane = 0;
+        while ((1L << numPlane) < multiwavePtr->modulus) {
+            numPlane++;
+        }
+        multiwavePtr->numPlane = numPlane;
+
+        multiwavePtr->numWord = 1 + multiwavePtr->numFront + numPlane;
+        multiwavePtr->rowWords = (uint64_t*)malloc(((width + 63) / 64) * sizeof(uint64_t));
+        assert(multiwavePtr->rowWords);
+        multiwavePtr->columnMasks = (uint64_t*)malloc(width * sizeof(uint64_t));
+        assert(multiwavePtr->columnMasks);
+
+        long numPoint = multiwavePtr->numPoint;
+        multiwavePtr->words = (uint64_t*)calloc(numPoint * multiwavePtr->numWord, sizeof(uint64_t));
+        assert(multiwavePtr->words);
+        long i;
+        for (i = 0; i < numPoint; i++) {
+            long p;
+            SEEN(multiwavePtr, i) = ~(uint64_t)0; /* border */
+            for (p = 0; p < numPlane; p++) {
+                PLANE(multiwavePtr, p, i) = ~(uint64_t)0;
+            }
+        }
+
+        long f;
+        multiwavePtr->lists = (index_list_t*)malloc(multiwavePtr->numFront * sizeof(index_list_t));
+        assert(multiwavePtr->lists);
+        for (f = 0; f < multiwavePtr->numFront; f++) {
+            index_list_t* listPtr = &multiwavePtr->lists[f];
+            listPtr->elements = (long*)malloc(MULTIWAVE_LIST_INIT_CAPACITY * sizeof(long));
+            assert(listPtr->elements);
+            listPtr->size = 0;
+            listPtr->capacity = MULTIWAVE_LIST_INIT_CAPACITY;
+        }
+    }
+
+    return multiwavePtr;
+}
+
+
+/* =============================================================================
+ * multiwave_free
+ * =============================================================================
+ */
+void multiwave_free (multiwave_t* multiwavePtr){
+    long f;
+
+    for (f = 0; f < multiwavePtr->numFront; f++) {
+        free(multiwavePtr->lists[f].elements);
+    }
+    free(multiwavePtr->lists);
+    free(multiwavePtr->rowWords);
+    free(multiwavePtr->columnMasks);
+    free(multiwavePtr->words);
+    free(multiwavePtr);
+}
+
+
+/* =============================================================================
+ * clearFront
+ * =============================================================================
+ */
+static void clearFront (multiwave_t* multiwavePtr, long f){
+    index_list_t* listPtr = &multiwavePtr->lists[f];
+    long i;
+
+    for (i = 0; i < listPtr->size; i++) {
+        FRONT(multiwavePtr, f, listPtr->elements[i]) = 0;
+    }
+    listPtr->size = 0;
+}
+
+
+/* =============================================================================
+ * setLabel
+ * -- Records 'wave' as the arrival of the nets in 'mask' at point 'index'
+ * =============================================================================
+ */
+static inline void setLabel (multiwave_t* multiwavePtr, long index, uint64_t mask, long wave){
+    long label = wave % multiwavePtr->modulus;
+    long p;
+
+    for (p = 0; p < multiwavePtr->numPlane; p++) {
+        if ((label >> p) & 1) {
+            PLANE(multiwavePtr, p, index) |= mask;
+        } else {
+            PLANE(multiwavePtr, p, index) &= ~mask;
+        }
+    }
+}
+
+
+/* =============================================================================
+ * getLabel
+ * =============================================================================
+ */
+static inline long getLabel (multiwave_t* multiwavePtr, long index, long lane){
+    long label = 0;
+    long p;
+
+    for (p = 0; p < multiwavePtr->numPlane; p++) {
+        label |= (long)((PLANE(multiwavePtr, p, index) >> lane) & 1) << p;
+    }
+
+    return label;
+}
+
+
+/* =============================================================================
+ * addToFront
+ * =============================================================================
+ */
+static inline void addToFront (multiwave_t* multiwavePtr, long to, long index, uint64_t mask){
+    uint64_t add = mask & ~SEEN(multiwavePtr, index);
+    if (add) {
+        if (FRONT(multiwavePtr, to, index) == 0) {
+            pushIndex(&multiwavePtr->lists[to], index);
+        }
+        FRONT(multiwavePtr, to, index) |= add;
+    }
+}
+
+
+/* =============================================================================
+ * spreadFront
+ * -- Pushes the nets in 'mask' from every point of frontier 'from' to its
+ *    neighbors in the same layer, or in the adjacent layers if 'isVia'
+ * =============================================================================
+ */
+static void spreadFront (multiwave_t* multiwavePtr, long from, long to, bool_t isVia, uint64_t mask){
+    index_list_t* fromListPtr = &multiwavePtr->lists[from];
+    long padWidth = multiwavePtr->padWidth;
+    long padArea = multiwavePtr->padArea;
+    long i;
+
+    for (i = 0; i < fromListPtr->size; i++) {
+        long index = fromListPtr->elements[i];
+        uint64_t front = FRONT(multiwavePtr, from, index) & mask;
+        if (front == 0) {
+            continue;
+        }
+        if (isVia) {
+            addToFront(multiwavePtr, to, index + padArea, front);
+            addToFront(multiwavePtr, to, index - padArea, front);
+        } else {
+            addToFront(multiwavePtr, to, index + 1,        front);
+            addToFront(multiwavePtr, to, index - 1,        front);
+            addToFront(multiwavePtr, to, index + padWidth, front);
+            addToFront(multiwavePtr, to, index - padWidth, front);
+        }
+    }
+}
+
+
+/* =============================================================================
+ * loadGrid
+ * -- Blocks every point the occupancy has set, for every net, and every
+ *    point outside the box of a net, for that net
+ * =============================================================================
+ */
+static void loadGrid (multiwave_t* multiwavePtr, occupancy_t* occupancyPtr, long numLane, coordinate_t** minPtrs, coordinate_t** maxPtrs){
+    uint64_t* rowWords = multiwavePtr->rowWords;
+    uint64_t* columnMasks = multiwavePtr->columnMasks;
+    long numPlane = multiwavePtr->numPlane;
+    long x;
+    long y;
+    long z;
+    long l;
+    long p;
+
+    memset(columnMasks, 0, multiwavePtr->width * sizeof(uint64_t));
+    for (l = 0; l < numLane; l++) {
+        for (x = minPtrs[l]->x; x <= maxPtrs[l]->x; x++) {
+            columnMasks[x] |= (uint64_t)1 << l;
+        }
+    }
+
+    for (z = 0; z < multiwavePtr->depth; z++) {
+        for (y = 0; y < multiwavePtr->height; y++) {
+            long rowIndex = (z + 1) * multiwavePtr->padArea + (y + 1) * multiwavePtr->padWidth + 1;
+            uint64_t rowMask = 0;
+            for (l = 0; l < numLane; l++) {
+                if (y >= minPtrs[l]->y && y <= maxPtrs[l]->y &&
+                    z >= minPtrs[l]->z && z <= maxPtrs[l]->z)
+                {
+                    rowMask |= (uint64_t)1 << l;
+                }
+            }
+            occupancy_getFreeRow(occupancyPtr, 0, y, z, multiwavePtr->width, rowWords);
+            for (x = 0; x < multiwavePtr->width; x++) {
+                long index = rowIndex + x;
+                uint64_t blocked = (((rowWords[x >> 6] >> (x & 63)) & 1) ?
+                                    ~(rowMask & columnMasks[x]) : ~(uint64_t)0);
+                SEEN(multiwavePtr, index) = blocked;
+                for (p = 0; p < numPlane; p++) {
+                    PLANE(multiwavePtr, p, index) |= blocked;
+                }
+            }
+        }
+    }
+}
+
+
+/* =============================================================================
+ * multiwave_expand
+ * -- Floods the occupancy from the sources of numLane <= MULTIWAVE_NUM_LANE
+ *    nets at once, net i in bit i of every point and confined to the box
+ *    [minPtrs[i], maxPtrs[i]], until each net reaches its destination or can
+ *    reach no further
+ * -- Returns the mask of nets whose destination was reached
+ * =============================================================================
+ */
+uint64_t multiwave_expand (multiwave_t* multiwavePtr, occupancy_t* occupancyPtr, long numLane, coordinate_t** srcPtrs, coordinate_t** dstPtrs, coordinate_t** minPtrs, coordinate_t** maxPtrs, multiwave_stats_t* statsPtr){
+    long numFront = multiwavePtr->numFront;
+    long zWave = multiwavePtr->zWave;
+    long l;
+
+    assert(numLane >= 1 && numLane <= MULTIWAVE_NUM_LANE);
+
+    loadGrid(multiwavePtr, occupancyPtr, numLane, minPtrs, maxPtrs);
+    statsPtr->numByte = multiwavePtr->numPoint * multiwavePtr->numWord * sizeof(uint64_t);
+
+    uint64_t activeMask = 0;
+    for (l = 0; l < numLane; l++) {
+        uint64_t bit = (uint64_t)1 << l;
+        long srcIndex = getIndex(multiwavePtr, srcPtrs[l]);
+        long dstIndex = getIndex(multiwavePtr, dstPtrs[l]);
+        multiwavePtr->srcIndex[l] = srcIndex;
+        multiwavePtr->dstIndex[l] = dstIndex;
+        multiwavePtr->distance[l] = -1;
+        SEEN(multiwavePtr, dstIndex) &= ~bit; /* always open to its own net */
+        activeMask |= bit;
+    }
+    for (l = 0; l < numLane; l++) {
+        uint64_t bit = (uint64_t)1 << l;
+        long srcIndex = multiwavePtr->srcIndex[l];
+        SEEN(multiwavePtr, srcIndex) |= bit;
+        if (FRONT(multiwavePtr, 0, srcIndex) == 0) {
+            pushIndex(&multiwavePtr->lists[0], srcIndex);
+        }
+        FRONT(multiwavePtr, 0, srcIndex) |= bit;
+        setLabel(multiwavePtr, srcIndex, bit, 0);
+    }
+
+    uint64_t foundMask = 0;
+    long numEmptyWave = 0;
+    long w;
+
+    for (w = 1; activeMask != 0; w++) {
+
+        long to = w % numFront;
+        clearFront(multiwavePtr, to);
+        long from = (w - 1) % numFront;
+        spreadFront(multiwavePtr, from, to, FALSE, activeMask);
+        if (w >= zWave) {
+            spreadFront(multiwavePtr, (w - zWave) % numFront, to, TRUE, activeMask);
+        }
+        statsPtr->numWave++;
+
+        index_list_t* toListPtr = &multiwavePtr->lists[to];
+        if (toListPtr->size == 0) {
+            if (++numEmptyWave >= zWave) {
+                break; /* no older wave can reach further */
+            }
+            continue;
+        }
+        numEmptyWave = 0;
+
+        long i;
+        for (i = 0; i < toListPtr->size; i++) {
+            long index = toListPtr->elements[i];
+            uint64_t add = FRONT(multiwavePtr, to, index);
+            SEEN(multiwavePtr, index) |= add;
+            setLabel(multiwavePtr, index, add, w);
+            statsPtr->numCellExpanded += __builtin_popcountll(add);
+        }
+
+        for (l = 0; l < numLane; l++) {
+            uint64_t bit = (uint64_t)1 << l;
+            if ((activeMask & bit) && (FRONT(multiwavePtr, to, multiwavePtr->dstIndex[l]) & bit)) {
+                multiwavePtr->distance[l] = w;
+                activeMask &= ~bit;
+                foundMask |= bit;
+            }
+        }
+    }
+
+    long f;
+    for (f = 0; f < numFront; f++) {
+        clearFront(multiwavePtr, f);
+    }
+
+    return foundMask;
+}
+
+
+/* =============================================================================
+ * multiwave_traceback
+ * -- Appends the path of net 'lane' from the last multiwave_expand to
+ *    pointVectorPtr, as indices into gridPtr from destination to source
+ * -- Returns FALSE if the net was not routed
+ * =============================================================================
+ */
+bool_t multiwave_traceback (multiwave_t* multiwavePtr, grid_t* gridPtr, long lane, indexvector_t* pointVectorPtr){
+    long distance = multiwavePtr->distance[lane];
+    if (distance < 0) {
+        return FALSE;
+    }
+
+    long padWidth = multiwavePtr->padWidth;
+    long padArea = multiwavePtr->padArea;
+    long offsets[6] = { 1, -1, padWidth, -padWidth, padArea, -padArea };
+    long steps[6] = { 1, 1, 1, 1, multiwavePtr->zWave, multiwavePtr->zWave };
+    long modulus = multiwavePtr->modulus;
+    long index = multiwavePtr->dstIndex[lane];
+    long lastMove = 0;
+
+    /* Each step takes at least one wave, so distance + 1 points is enough */
+    bool_t status = indexvector_reserve(pointVectorPtr, indexvector_getSize(pointVectorPtr) + distance + 1);
+    assert(status);
+    indexvector_pushBack(pointVectorPtr, getGridPointRef(multiwavePtr, gridPtr, index) - gridPtr->points);
+
+    while (distance > 0) {
+        long m;
+        long move = -1;
+        /* Keep going straight when possible, as the bend cost asks */
+        for (m = -1; m < 6; m++) {
+            long candidate = ((m < 0) ? lastMove : m);
+            long next = distance - steps[candidate];
+            long neighbor = index + offsets[candidate];
+            if (next >= 0 &&
+                ((SEEN(multiwavePtr, neighbor) >> lane) & 1) &&
+                getLabel(multiwavePtr, neighbor, lane) == next % modulus)
+            {
+                move = candidate;
+                break;
+            }
+        }
+        if (move < 0) {
+            return FALSE;
+        }
+        index += offsets[move];
+        distance -= steps[move];
+        lastMove = move;
+        indexvector_pushBack(pointVectorPtr, getGridPointRef(multiwavePtr, gridPtr, index) - gridPtr->points);
+    }
+
+    assert(index == multiwavePtr->srcIndex[lane]);
+
+    return TRUE;
+}
+
+
+/* =============================================================================
+ *
+ * End of multiwave.c
+ *
+ * =============================================================================
+ */
@@ -0,0 +1,132 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * multiwave.h
+ *
+ * =============================================================================
+ */
+
+
+#ifndef MULTIWAVE_H
+#define MULTIWAVE_H 1
+
+
+#include <stdint.h>
+#include "coordinate.h"
+#include "grid.h"
+#include "occupancy.h"
+#include "path.h"
+#include "lib/types.h"
+
+typedef struct multiwave multiwave_t;
+
+enum multiwave_config {
+    MULTIWAVE_NUM_LANE = 64, /* nets per batch, one bit each */
+};
+
+typedef struct multiwave_stats {
+    long numCellExpanded; /* (point, net) pairs labeled */
+    long numWave;         /* waves advanced */
+    long numByte;         /* size of the lane records */
+} multiwave_stats_t;
+
+
+/* =============================================================================
+ * multiwave_isSupported
+ * -- TRUE if xCost == yCost >= 1 and zCost is a multiple of it
+ * =============================================================================
+ */
+bool_t multiwave_isSupported (long xCost, long yCost, long zCost);
+
+
+/* =============================================================================
+ * multiwave_alloc
+ * -- Sized for grids of width x height x depth; costs must satisfy
+ *    multiwave_isSupported
+ * =============================================================================
+ */
+multiwave_t* multiwave_alloc (long width, long height, long depth, long xCost, long yCost, long zCost);
+
+
+/* =============================================================================
+ * multiwave_free
+ * =============================================================================
+ */
+void multiwave_free (multiwave_t* multiwavePtr);
+
+
+/* =============================================================================
+ * multiwave_expand
+ * -- Floods the occupancy from the sources of numLane <= MULTIWAVE_NUM_LANE
+ *    nets at once, net i in bit i of every point and confined to the box
+ *    [minPtrs[i], maxPtrs[i]], until each net reaches its destination or can
+ *    reach no further
+ * -- Returns the mask of nets whose destination was reached
+ * =============================================================================
+ */
+uint64_t multiwave_expand (multiwave_t* multiwavePtr, occupancy_t* occupancyPtr, long numLane, coordinate_t** srcPtrs, coordinate_t** dstPtrs, coordinate_t** minPtrs, coordinate_t** maxPtrs, multiwave_stats_t* statsPtr);
+
+
+/* =============================================================================
+ * multiwave_traceback
+ * -- Appends the path of net 'lane' from the last multiwave_expand to
+ *    pointVectorPtr, as indices into gridPtr from destination to source
+ * -- Returns FALSE if the net was not routed
+ * =============================================================================
+ */
+bool_t multiwave_traceback (multiwave_t* multiwavePtr, grid_t* gridPtr, long lane, indexvector_t* pointVectorPtr);
+
+
+#endif /* MULTIWAVE_H */
+
+
+/* =============================================================================
+ *
+ * End of multiwave.h
+ *
+ * =============================================================================
+ */
@@ -0,0 +1,556 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * occupancy.c
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "coordinate.h"
+#include "grid.h"
+#include "occupancy.h"
+#include "path.h"
+#include "lib/types.h"
+
+
+#define OCCUPANCY_WORD(i)  ((i) >> 6)
+#define OCCUPANCY_BIT(i)   ((uint64_t)1 << ((i) & 63))
+
+#define OCCUPANCY_REGION(occupancyPtr, x, y) \
+    ((((y) >> OCCUPANCY_REGION_SHIFT) * (occupancyPtr)->regionWidth) + ((x) >> OCCUPANCY_REGION_SHIFT))
+
+
+/* =============================================================================
+ * occupancy_alloc
+ * -- Every full point of gridPtr starts out set
+ * =============================================================================
+ */
+occupancy_t* occupancy_alloc (grid_t* gridPtr, long maxCommit){
+    occupancy_t* occupancyPtr = (occupancy_t*)malloc(sizeof(occupancy_t));
+    assert(occupancyPtr);
+
+    long n = gridPtr->numPoint;
+    occupancyPtr->width  = gridPtr->width;
+    occupancyPtr->height = gridPtr->height;
+    occupancyPtr->depth  = gridPtr->depth;
+    occupancyPtr->words = (uint64_t*)calloc(OCCUPANCY_WORD(n) + 1, sizeof(uint64_t));
+    assert(occupancyPtr->words);
+    /* NULL marks a slot not published yet */
+    occupancyPtr->commits = (path_t**)calloc(((maxCommit > 0) ? maxCommit : 1), sizeof(path_t*));
+    assert(occupancyPtr->commits);
+    occupancyPtr->maxCommit = maxCommit;
+    occupancyPtr->numCommit = 0;
+    occupancyPtr->numRollback = 0;
+    occupancyPtr->regionWidth = ((gridPtr->width  + (1L << OCCUPANCY_REGION_SHIFT) - 1) >> OCCUPANCY_REGION_SHIFT);
+    long regionHeight         = ((gridPtr->height + (1L << OCCUPANCY_REGION_SHIFT) - 1) >> OCCUPANCY_REGION_SHIFT);
+    occupancyPtr->numRegion = occupancyPtr->regionWidth * regionHeight;
+    occupancyPtr->versions = (unsigned long*)calloc(occupancyPtr->numRegion, sizeof(unsigned long));
+    assert(occupancyPtr->versions);
+
+    long i;
+    for (i = 0; i < n; i++) {
+        if (gridPtr->points[i] == GRID_POINT_FULL) {
+            occupancyPtr->words[OCCUPANCY_WORD(i)] |= OCCUPANCY_BIT(i);
+        }
+    }
+
+    return occupancyPtr;
+}
+
+
+/* =============================================================================
+ * occupancy_free
+ * =============================================================================
+ */
+void occupancy_free (occupancy_t* occupancyPtr){
+    free(occupancyPtr->words);
+    free(occupancyPtr->commits);
+    free(occupancyPtr->versions);
+    free(occupancyPtr);
+}
+
+
+/* =============================================================================
+ * occupancy_isPointFull
+ * =============================================================================
+ */
+bool_t occupancy_isPointFull (occupancy_t* occupancyPtr, long x, long y, long z){
+    long i = grid_getIndex(occupancyPtr->width, occupancyPtr->height, x, y, z);
+    return ((occupancyPtr->words[OCCUPANCY_WORD(i)] & OCCUPANCY_BIT(i)) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * occupancy_isPathFree
+ * -- TRUE if no interior point of the path is set; gridPtr gives the shape
+ * =============================================================================
+ */
+bool_t occupancy_isPathFree (occupancy_t* occupancyPtr, grid_t* gridPtr, path_t* pathPtr){
+    long n = path_getNumPoint(pathPtr);
+    path_iter_t it;
+
+    path_iter_reset(&it, pathPtr);
+    path_iter_next(&it, gridPtr, pathPtr); /* skip the first end point */
+    while (it.pointNum < (n-1)) {
+        path_iter_next(&it, gridPtr, pathPtr);
+        long p = it.index;
+        if (occupancyPtr->words[OCCUPANCY_WORD(p)] & OCCUPANCY_BIT(p)) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+
+/* =============================================================================
+ * logPath
+ * -- Call after the path's bits are set: appends it to the log, then bumps
+ *    the version of every region it crosses. A reader that sees a bump has
+ *    the path's bits and log slot too.
+ * =============================================================================
+ */
+static void logPath (occupancy_t* occupancyPtr, grid_t* gridPtr, path_t* pathPtr){
+    long c = __atomic_fetch_add(&occupancyPtr->numCommit, 1, __ATOMIC_RELAXED);
+    assert(c < occupancyPtr->maxCommit);
+    __atomic_store_n(&occupancyPtr->commits[c], pathPtr, __ATOMIC_RELEASE);
+
+    long n = path_getNumPoint(pathPtr);
+    long lastRegion = -1;
+    path_iter_t it;
+    path_iter_reset(&it, pathPtr);
+    path_iter_next(&it, gridPtr, pathPtr); /* skip the first end point */
+    while (it.pointNum < (n-1)) {
+        path_iter_next(&it, gridPtr, pathPtr);
+        long r = OCCUPANCY_REGION(occupancyPtr, it.coordinate.x, it.coordinate.y);
+        if (r != lastRegion) {
+            /* A region entered twice is bumped twice; only change matters */
+            __atomic_fetch_add(&occupancyPtr->versions[r], 1, __ATOMIC_RELEASE);
+            lastRegion = r;
+        }
+    }
+}
+
+
+/* =============================================================================
+ * occupancy_addPath
+ * -- Sets the interior points of the path; gridPtr gives the shape
+ * =============================================================================
+ */
+void occupancy_addPath (occupancy_t* occupancyPtr, grid_t* gridPtr, path_t* pathPtr){
+    long n = path_getNumPoint(pathPtr);
+    path_iter_t it;
+
+    path_iter_reset(&it, pathPtr);
+    path_iter_next(&it, gridPtr, pathPtr); /* skip the first end point */
+    while (it.pointNum < (n-1)) {
+        path_iter_next(&it, gridPtr, pathPtr);
+        long p = it.index;
+        occupancyPtr->words[OCCUPANCY_WORD(p)] |= OCCUPANCY_BIT(p);
+    }
+
+    logPath(occupancyPtr, gridPtr, pathPtr);
+}
+
+
+/* =============================================================================
+ * claimWord
+ * -- Sets 'mask' in the word; returns the bits of it that were already set,
+ *    after clearing again the ones this call set
+ * =============================================================================
+ */
+static uint64_t claimWord (uint64_t* wordPtr, uint64_t mask){
+    uint64_t taken = __atomic_fetch_or(wordPtr, mask, __ATOMIC_ACQ_REL) & mask;
+    if (taken) {
+        __atomic_fetch_and(wordPtr, ~(mask & ~taken), __ATOMIC_RELEASE);
+    }
+    return taken;
+}
+
+
+/* =============================================================================
+ * occupancy_claimPath
+ * -- Runs of path points that share a word (straight x runs, mostly) are
+ *    claimed with a single atomic OR
+ * =============================================================================
+ */
+bool_t occupancy_claimPath (occupancy_t* occupancyPtr, grid_t* gridPtr, path_t* pathPtr){
+    uint64_t* words = occupancyPtr->words;
+    long n = path_getNumPoint(pathPtr);
+    long numClaimed = 0; /* interior points whose words are claimed, in path order */
+    long numPending = 0; /* points gathered into 'mask' since */
+    long w = -1;
+    uint64_t mask = 0;
+    bool_t isTaken = FALSE;
+    path_iter_t it;
+
+    path_iter_reset(&it, pathPtr);
+    path_iter_next(&it, gridPtr, pathPtr); /* skip the first end point */
+    while (it.pointNum < (n-1)) {
+        path_iter_next(&it, gridPtr, pathPtr);
+        long p = it.index;
+        if (OCCUPANCY_WORD(p) != w) {
+            if (mask && claimWord(&words[w], mask)) {
+                isTaken = TRUE;
+                break;
+            }
+            numClaimed += numPending;
+            numPending = 0;
+            w = OCCUPANCY_WORD(p);
+            mask = 0;
+        }
+        mask |= OCCUPANCY_BIT(p);
+        numPending++;
+    }
+    if (!isTaken && mask && claimWord(&words[w], mask)) {
+        isTaken = TRUE;
+    }
+
+    if (isTaken) {
+        /* Give back the words claimed before the one that was taken */
+        path_iter_reset(&it, pathPtr);
+        path_iter_next(&it, gridPtr, pathPtr);
+        long k;
+        for (k = 0; k < numClaimed; k++) {
+            path_iter_next(&it, gridPtr, pathPtr);
+            long p = it.index;
+            __atomic_fetch_and(&words[OCCUPANCY_WORD(p)], ~OCCUPANCY_BIT(p), __ATOMIC_RELEASE);
+        }
+        __atomic_fetch_add(&occupancyPtr->numRollback, 1, __ATOMIC_RELEASE);
+        return FALSE;
+    }
+
+    logPath(occupancyPtr, gridPtr, pathPtr);
+
+    return TRUE;
+}
+
+
+/* =============================================================================
+ * occupancy_isTransactionSupported
+ * =============================================================================
+ */
+bool_t occupancy_isTransactionSupported (){
+#ifdef OCCUPANCY_GNU_TM
+    return TRUE;
+#else
+    return FALSE;
+#endif
+}
+
+
+#ifdef OCCUPANCY_GNU_TM
+/* =============================================================================
+ * countAttempt
+ * -- Not instrumented, so the count survives the aborts it counts
+ * =============================================================================
+ */
+__attribute__((transaction_pure))
+static void countAttempt (long* numAttemptPtr){
+    (*numAttemptPtr)++;
+}
+#endif
+
+
+/* =============================================================================
+ * occupancy_transactPath
+ * =============================================================================
+ */
+bool_t occupancy_transactPath (occupancy_t* occupancyPtr, grid_t* gridPtr, path_t* pathPtr, long* numAttemptPtr){
+#ifdef OCCUPANCY_GNU_TM
+    uint64_t* words = occupancyPtr->words;
+    long n = path_getNumPoint(pathPtr);
+    bool_t isFree = TRUE;
+
+    __transaction_atomic {
+        countAttempt(numAttemptPtr);
+        isFree = TRUE;
+        path_iter_t it;
+        path_iter_reset(&it, pathPtr);
+        path_iter_next(&it, gridPtr, pathPtr); /* skip the first end point */
+        while (it.pointNum < (n-1)) {
+            path_iter_next(&it, gridPtr, pathPtr);
+            long p = it.index;
+            if (words[OCCUPANCY_WORD(p)] & OCCUPANCY_BIT(p)) {
+                isFree = FALSE;
+                break;
+            }
+        }
+        if (isFree) {
+            path_iter_reset(&it, pathPtr);
+            path_iter_next(&it, gridPtr, pathPtr);
+            while (it.pointNum < (n-1)) {
+                path_iter_next(&it, gridPtr, pathPtr);
+                long p = it.index;
+                words[OCCUPANCY_WORD(p)] |= OCCUPANCY_BIT(p);
+            }
+        }
+    }
+
+    if (!isFree) {
+        __atomic_fetch_add(&occupancyPtr->numRollback, 1, __ATOMIC_RELEASE);
+        return FALSE;
+    }
+    logPath(occupancyPtr, gridPtr, pathPtr);
+
+    return TRUE;
+#else
+    assert(FALSE); /* see occupancy_isTransactionSupported */
+    return FALSE;
+#endif
+}
+
+
+/* =============================================================================
+ * occupancy_fillGrid
+ * -- Writes GRID_POINT_FULL or GRID_POINT_EMPTY to every point of myGridPtr
+ *    in the box [minPtr, maxPtr]; points outside it are left as they are
+ * -- Works a word of bits at a time: runs with no bit set are one memset,
+ *    since GRID_POINT_EMPTY is zero
+ * =============================================================================
+ */
+void occupancy_fillGrid (occupancy_t* occupancyPtr, grid_t* myGridPtr, coordinate_t* minPtr, coordinate_t* maxPtr){
+    uint64_t* words = occupancyPtr->words;
+    long numX = maxPtr->x - minPtr->x + 1;
+    long y;
+    long z;
+
+    for (z = minPtr->z; z <= maxPtr->z; z++) {
+        for (y = minPtr->y; y <= maxPtr->y; y++) {
+            grid_point_t* gridPointPtr = grid_getPointRef(myGridPtr, minPtr->x, y, z);
+            long i = grid_getIndex(occupancyPtr->width, occupancyPtr->height, minPtr->x, y, z);
+            long end = i + numX;
+            while (i < end) {
+                long shift = i & 63;
+                long span = ((64 - shift < end - i) ? (64 - shift) : (end - i));
+                uint64_t word = words[OCCUPANCY_WORD(i)] >> shift;
+                if (span < 64) {
+                    word &= ((uint64_t)1 << span) - 1;
+                }
+                if (word == 0) {
+                    memset(gridPointPtr, 0, span * sizeof(grid_point_t));
+                } else {
+                    long k;
+                    for (k = 0; k < span; k++) {
+                        gridPointPtr[k] = (((word >> k) & 1) ? GRID_POINT_FULL : GRID_POINT_EMPTY);
+                    }
+                }
+                gridPointPtr += span;
+                i += span;
+            }
+        }
+    }
+}
+
+
+/* =============================================================================
+ * occupancy_getFreeRow
+ * -- Sets bit k & 63 of rowPtr[k / 64] if point (x + k, y, z) is not set, for
+ *    k < numX, and clears the rest of those words
+ * -- The row is a run of our bits, taken a word at a time
+ * =============================================================================
+ */
+void occupancy_getFreeRow (occupancy_t* occupancyPtr, long x, long y, long z, long numX, uint64_t* rowPtr){
+    uint64_t* words = occupancyPtr->words;
+    long i = grid_getIndex(occupancyPtr->width, occupancyPtr->height, x, y, z);
+    long shift = i & 63;
+    long k;
+
+    for (k = 0; k < numX; k += 64) {
+        long span = ((numX - k < 64) ? (numX - k) : 64);
+        long w = OCCUPANCY_WORD(i + k);
+        uint64_t word = words[w] >> shift;
+        if (shift + span > 64) {
+            word |= words[w + 1] << (64 - shift); /* the run straddles two words */
+        }
+        word = ~word;
+        if (span < 64) {
+            word &= ((uint64_t)1 << span) - 1;
+        }
+        rowPtr[k >> 6] = word;
+    }
+}
+
+
+/* =============================================================================
+ * occupancy_getNumCommit
+ * =============================================================================
+ */
+long occupancy_getNumCommit (occupancy_t* occupancyPtr){
+    long c = 0;
+    while (c < occupancyPtr->maxCommit &&
+           __atomic_load_n(&occupancyPtr->commits[c], __ATOMIC_ACQUIRE) != NULL)
+    {
+        c++;
+    }
+
+    return c;
+}
+
+
+/* =============================================================================
+ * occupancy_getNumRollback
+ * =============================================================================
+ */
+long occupancy_getNumRollback (occupancy_t* occupancyPtr){
+    return __atomic_load_n(&occupancyPtr->numRollback, __ATOMIC_ACQUIRE);
+}
+
+
+/* =============================================================================
+ * occupancy_syncGrid
+ * =============================================================================
+ */
+void occupancy_syncGrid (occupancy_t* occupancyPtr, grid_t* myGridPtr, long* numCommitPtr, indexvector_t* labelVectorPtr){
+    long c;
+
+    for (c = *numCommitPtr; c < occupancyPtr->maxCommit; c++) {
+        path_t* pathPtr = __atomic_load_n(&occupancyPtr->commits[c], __ATOMIC_ACQUIRE);
+        if (pathPtr == NULL) {
+            break; /* reserved but not published yet; replay it next time */
+        }
+        long n = path_getNumPoint(pathPtr);
+        path_iter_t it;
+        path_iter_reset(&it, pathPtr);
+        path_iter_next(&it, myGridPtr, pathPtr); /* skip the first end point */
+        while (it.pointNum < (n-1)) {
+            path_iter_next(&it, myGridPtr, pathPtr);
+            if (labelVectorPtr && myGridPtr->points[it.index] > GRID_POINT_EMPTY) {
+                bool_t status = indexvector_pushBack(labelVectorPtr, it.index);
+                assert(status);
+            }
+            myGridPtr->points[it.index] = GRID_POINT_FULL;
+        }
+    }
+    *numCommitPtr = c;
+}
+
+
+/* =============================================================================
+ * occupancy_readVersions
+ * =============================================================================
+ */
+void occupancy_readVersions (occupancy_t* occupancyPtr, unsigned long* versions){
+    long r;
+    for (r = 0; r < occupancyPtr->numRegion; r++) {
+        versions[r] = __atomic_load_n(&occupancyPtr->versions[r], __ATOMIC_RELAXED);
+    }
+    /* Order the bit and log reads that follow after these */
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+
+/* =============================================================================
+ * occupancy_getPathRegions
+ * =============================================================================
+ */
+void occupancy_getPathRegions (occupancy_t* occupancyPtr, grid_t* gridPtr, path_t* pathPtr, indexvector_t* regionVectorPtr){
+    long n = path_getNumPoint(pathPtr);
+    long lastRegion = -1;
+    path_iter_t it;
+
+    indexvector_clear(regionVectorPtr);
+    path_iter_reset(&it, pathPtr);
+    path_iter_next(&it, gridPtr, pathPtr); /* skip the first end point */
+    while (it.pointNum < (n-1)) {
+        path_iter_next(&it, gridPtr, pathPtr);
+        long r = OCCUPANCY_REGION(occupancyPtr, it.coordinate.x, it.coordinate.y);
+        if (r != lastRegion) {
+            bool_t status = indexvector_pushBack(regionVectorPtr, r);
+            assert(status);
+            lastRegion = r;
+        }
+    }
+}
+
+
+/* =============================================================================
+ * occupancy_areRegionsUnchanged
+ * =============================================================================
+ */
+bool_t occupancy_areRegionsUnchanged (occupancy_t* occupancyPtr, indexvector_t* regionVectorPtr, unsigned long* versions){
+    long numRegion = indexvector_getSize(regionVectorPtr);
+    long k;
+
+    for (k = 0; k < numRegion; k++) {
+        long r = *indexvector_at(regionVectorPtr, k);
+        if (__atomic_load_n(&occupancyPtr->versions[r], __ATOMIC_ACQUIRE) != versions[r]) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+
+/* =============================================================================
+ * occupancy_resetPoints
+ * =============================================================================
+ */
+void occupancy_resetPoints (occupancy_t* occupancyPtr, grid_t* myGridPtr, uint32_t* indices, long numIndex){
+    uint64_t* words = occupancyPtr->words;
+    grid_point_t* points = myGridPtr->points;
+    long k;
+
+    for (k = 0; k < numIndex; k++) {
+        long i = indices[k];
+        points[i] = ((words[OCCUPANCY_WORD(i)] & OCCUPANCY_BIT(i)) ? GRID_POINT_FULL : GRID_POINT_EMPTY);
+    }
+}
+
+
+/* =============================================================================
+ *
+ * End of occupancy.c
+ *
+ * =============================================================================
+ */
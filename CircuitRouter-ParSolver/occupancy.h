@@ -0,0 +1,273 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * occupancy.h
+ *
+ * =============================================================================
+ */
+
+
+#ifndef OCCUPANCY_H
+#define OCCUPANCY_H 1
+
+
+#include <stdint.h>
+#include "coordinate.h"
+#include "grid.h"
+#include "path.h"
+#include "lib/types.h"
+
+/*
+ * The state the router threads share: one bit per grid point, set once the
+ * point is taken by a wall, an end point or a committed path. Points are
+ * numbered as in grid_t, so a path's point indices index it too.
+ *
+ * Committed paths are also appended to a log, so a private grid can catch up
+ * with the paths added since it last looked instead of being rebuilt. A
+ * committer reserves a slot with an atomic add and publishes the path into
+ * it, so commits need not be serialized; readers stop at the first slot not
+ * published yet and pick up from there next time.
+ *
+ * Every region of OCCUPANCY_REGION_SIZE x OCCUPANCY_REGION_SIZE columns, all
+ * layers deep, has a version that each commit crossing it bumps after its
+ * bits and log slot are out. A reader that saves the versions before copying
+ * bits or replaying the log knows, later, whether a region moved on since:
+ * if none of a path's regions did, no commit has touched its points.
+ *
+ * occupancy_claimPath sets bits that it may clear again on a conflict. Such
+ * a bit can be copied into a private grid in between and no later commit
+ * will clear it there, so every rollback bumps numRollback for readers that
+ * keep a private grid across nets.
+ */
+enum occupancy_config {
+    OCCUPANCY_REGION_SHIFT = 4,
+    OCCUPANCY_REGION_SIZE  = (1 << OCCUPANCY_REGION_SHIFT),
+};
+
+typedef struct occupancy {
+    long width;
+    long height;
+    long depth;
+    uint64_t* words;
+    path_t** commits;   /* in commit order; one slot per path to route */
+    long maxCommit;
+    long numCommit;     /* slots reserved; a slot is published after the bits */
+    long numRollback;   /* claims undone by occupancy_claimPath */
+    long regionWidth;   /* regions along x */
+    long numRegion;
+    unsigned long* versions; /* per region; bumped by every commit crossing it */
+} occupancy_t;
+
+
+/* =============================================================================
+ * occupancy_alloc
+ * -- Every full point of gridPtr starts out set
+ * -- At most maxCommit paths may be added
+ * =============================================================================
+ */
+occupancy_t* occupancy_alloc (grid_t* gridPtr, long maxCommit);
+
+
+/* =============================================================================
+ * occupancy_free
+ * =============================================================================
+ */
+void occupancy_free (occupancy_t* occupancyPtr);
+
+
+/* =============================================================================
+ * occupancy_isPointFull
+ * =============================================================================
+ */
+bool_t occupancy_isPointFull (occupancy_t* occupancyPtr, long x, long y, long z);
+
+
+/* =============================================================================
+ * occupancy_isPathFree
+ * -- TRUE if no interior point of the path is set; gridPtr gives the shape
+ * =============================================================================
+ */
+bool_t occupancy_isPathFree (occupancy_t* occupancyPtr, grid_t* gridPtr, path_t* pathPtr);
+
+
+/* =============================================================================
+ * occupancy_addPath
+ * -- Sets the interior points of the path and logs it; gridPtr gives the shape
+ * -- Callers make sure no other thread takes the points in the meantime,
+ *    usually by holding the lock they checked occupancy_isPathFree under
+ * =============================================================================
+ */
+void occupancy_addPath (occupancy_t* occupancyPtr, grid_t* gridPtr, path_t* pathPtr);
+
+
+/* =============================================================================
+ * occupancy_claimPath
+ * -- Lock-free occupancy_isPathFree plus occupancy_addPath: sets the interior
+ *    points of the path one atomic OR at a time and, if one was set already,
+ *    clears the ones it set and returns FALSE
+ * -- Two threads claiming crossing paths may both fail
+ * =============================================================================
+ */
+bool_t occupancy_claimPath (occupancy_t* occupancyPtr, grid_t* gridPtr, path_t* pathPtr);
+
+
+/* =============================================================================
+ * occupancy_isTransactionSupported
+ * -- TRUE if built with OCCUPANCY_GNU_TM (make TM=gnu)
+ * =============================================================================
+ */
+bool_t occupancy_isTransactionSupported ();
+
+
+/* =============================================================================
+ * occupancy_transactPath
+ * -- occupancy_isPathFree plus occupancy_addPath in one GCC transaction
+ *    (-fgnu-tm); the log append follows the transaction
+ * -- Adds the times the transaction body ran to *numAttemptPtr, so that
+ *    minus the calls is its aborts
+ * -- A failed check counts as a rollback: an aborted run may have set bits
+ *    that a reader copied before they were undone
+ * =============================================================================
+ */
+bool_t occupancy_transactPath (occupancy_t* occupancyPtr, grid_t* gridPtr, path_t* pathPtr, long* numAttemptPtr);
+
+
+/* =============================================================================
+ * occupancy_fillGrid
+ * -- Writes GRID_POINT_FULL or GRID_POINT_EMPTY to every point of myGridPtr
+ *    in the box [minPtr, maxPtr]; points outside it are left as they are
+ * -- myGridPtr may be a window (see grid_setWindow) covering the box
+ * =============================================================================
+ */
+void occupancy_fillGrid (occupancy_t* occupancyPtr, grid_t* myGridPtr, coordinate_t* minPtr, coordinate_t* maxPtr);
+
+
+/* =============================================================================
+ * occupancy_getFreeRow
+ * -- Sets bit k & 63 of rowPtr[k / 64] if point (x + k, y, z) is not set, for
+ *    k < numX, and clears the rest of those words
+ * =============================================================================
+ */
+void occupancy_getFreeRow (occupancy_t* occupancyPtr, long x, long y, long z, long numX, uint64_t* rowPtr);
+
+
+/* =============================================================================
+ * occupancy_getNumCommit
+ * -- Paths logged so far without a gap; their points are visible once this
+ *    is read
+ * =============================================================================
+ */
+long occupancy_getNumCommit (occupancy_t* occupancyPtr);
+
+
+/* =============================================================================
+ * occupancy_getNumRollback
+ * -- Read it before copying bits; if it changed since, a copied bit may be
+ *    stale
+ * =============================================================================
+ */
+long occupancy_getNumRollback (occupancy_t* occupancyPtr);
+
+
+/* =============================================================================
+ * occupancy_readVersions
+ * -- Saves every region's version into 'versions' (numRegion of them); call
+ *    it before copying bits or replaying the log into a private grid
+ * =============================================================================
+ */
+void occupancy_readVersions (occupancy_t* occupancyPtr, unsigned long* versions);
+
+
+/* =============================================================================
+ * occupancy_getPathRegions
+ * -- Lists the regions the interior of the path crosses, in path order
+ * =============================================================================
+ */
+void occupancy_getPathRegions (occupancy_t* occupancyPtr, grid_t* gridPtr, path_t* pathPtr, indexvector_t* regionVectorPtr);
+
+
+/* =============================================================================
+ * occupancy_areRegionsUnchanged
+ * -- TRUE if no region in the list was bumped since 'versions' was read
+ * -- Only conclusive while no commit can be under way, e.g. under the lock
+ *    occupancy_addPath callers hold: a commit bumps after setting bits
+ * =============================================================================
+ */
+bool_t occupancy_areRegionsUnchanged (occupancy_t* occupancyPtr, indexvector_t* regionVectorPtr, unsigned long* versions);
+
+
+/* =============================================================================
+ * occupancy_syncGrid
+ * -- Writes GRID_POINT_FULL to the interior points of every path logged
+ *    since *numCommitPtr and advances *numCommitPtr past them
+ * -- If labelVectorPtr is not NULL, appends to it the index of every label
+ *    (value above GRID_POINT_EMPTY) it overwrote
+ * -- myGridPtr has the occupancy's shape
+ * =============================================================================
+ */
+void occupancy_syncGrid (occupancy_t* occupancyPtr, grid_t* myGridPtr, long* numCommitPtr, indexvector_t* labelVectorPtr);
+
+
+/* =============================================================================
+ * occupancy_resetPoints
+ * -- Writes GRID_POINT_FULL or GRID_POINT_EMPTY to the points of myGridPtr
+ *    listed in indices, as occupancy_fillGrid would
+ * -- myGridPtr has the occupancy's shape
+ * =============================================================================
+ */
+void occupancy_resetPoints (occupancy_t* occupancyPtr, grid_t* myGridPtr, uint32_t* indices, long numIndex);
+
+
+#endif /* OCCUPANCY_H */
+
+
+/* =============================================================================
+ *
+ * End of occupancy.h
+ *
+ * =============================================================================
+ */
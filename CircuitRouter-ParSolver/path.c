@@ -0,0 +1,159 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * path.c
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include "grid.h"
+#include "path.h"
+#include "lib/vector.h"
+
+
+/* =============================================================================
+ * getMove
+ * -- The grid move from point 'index' to point 'nextIndex'; tries 'lastMove'
+ *    first since paths run straight more often than they bend
+ * =============================================================================
+ */
+static grid_move_t getMove (grid_t* gridPtr, long index, long nextIndex, grid_move_t lastMove){
+    if (grid_getNeighborIndex(gridPtr, index, lastMove) == nextIndex) {
+        return lastMove;
+    }
+
+    long m;
+    for (m = 0; m < GRID_NUM_MOVE; m++) {
+        if (grid_getNeighborIndex(gridPtr, index, (grid_move_t)m) == nextIndex) {
+            return (grid_move_t)m;
+        }
+    }
+
+    assert(0); /* points of a path are always neighbors */
+    return lastMove;
+}
+
+
+/* =============================================================================
+ * encodeSegments
+ * -- Returns the number of segments; writes them too unless 'segments' is NULL
+ * =============================================================================
+ */
+static long encodeSegments (grid_t* gridPtr, indexvector_t* pointVectorPtr, uint16_t* segments){
+    long* indices = indexvector_at(pointVectorPtr, 0);
+    long numPoint = indexvector_getSize(pointVectorPtr);
+    long numSegment = 0;
+    long index = indices[0];
+    grid_move_t move = GRID_MOVE_POSX;
+    long length = 0;
+    long i;
+
+    for (i = 1; i < numPoint; i++) {
+        long nextIndex = indices[i];
+        grid_move_t nextMove = getMove(gridPtr, index, nextIndex, move);
+        if (length > 0 && (nextMove != move || length == PATH_MAX_LENGTH)) {
+            if (segments) {
+                segments[numSegment] = PATH_SEGMENT(move, length);
+            }
+            numSegment++;
+            length = 0;
+        }
+        move = nextMove;
+        length++;
+        index = nextIndex;
+    }
+
+    if (length > 0) {
+        if (segments) {
+            segments[numSegment] = PATH_SEGMENT(move, length);
+        }
+        numSegment++;
+    }
+
+    return numSegment;
+}
+
+
+/* =============================================================================
+ * path_alloc
+ * =============================================================================
+ */
+path_t* path_alloc (grid_t* gridPtr, indexvector_t* pointVectorPtr){
+    assert(indexvector_getSize(pointVectorPtr) > 0);
+
+    long numSegment = encodeSegments(gridPtr, pointVectorPtr, NULL);
+    path_t* pathPtr = (path_t*)malloc(sizeof(path_t) + numSegment * sizeof(uint16_t));
+    if (pathPtr) {
+        encodeSegments(gridPtr, pointVectorPtr, pathPtr->segments);
+        grid_getPointIndices(gridPtr, &gridPtr->points[*indexvector_at(pointVectorPtr, 0)],
+                             &pathPtr->start.x, &pathPtr->start.y, &pathPtr->start.z);
+        pathPtr->numPoint = indexvector_getSize(pointVectorPtr);
+        pathPtr->numSegment = numSegment;
+    }
+
+    return pathPtr;
+}
+
+
+/* =============================================================================
+ * path_free
+ * =============================================================================
+ */
+void path_free (path_t* pathPtr){
+    free(pathPtr);
+}
+
+
+/* =============================================================================
+ *
+ * End of path.c
+ *
+ * =============================================================================
+ */
@@ -0,0 +1,199 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * path.h
+ *
+ * =============================================================================
+ */
+
+
+#ifndef PATH_H
+#define PATH_H 1
+
+
+#include <stdint.h>
+#include "coordinate.h"
+#include "grid.h"
+#include "lib/types.h"
+#include "lib/vector.h"
+
+/*
+ * A routed path as its first point and the moves that lead on from there,
+ * run-length encoded: each segment is PATH_SEGMENT(move, length), 'length'
+ * steps along one grid move. Allocated in one block with its segments.
+ */
+typedef struct path {
+    coordinate_t start;
+    long numPoint;
+    long numSegment;
+    uint16_t segments[];
+} path_t;
+
+enum path_config {
+    PATH_MOVE_BITS   = 3,
+    PATH_MAX_LENGTH  = (UINT16_MAX >> PATH_MOVE_BITS), /* longer runs are split */
+    PATH_NUM_INLINE_POINT = 256, /* indexvector: points held without a malloc */
+};
+
+/*
+ * Point indices of a path as a traceback collects them, for path_alloc
+ */
+VECTOR_DEFINE_TYPED(indexvector, long, PATH_NUM_INLINE_POINT)
+
+#define PATH_SEGMENT(move, length)  ((uint16_t)(((length) << PATH_MOVE_BITS) | (move)))
+#define PATH_SEGMENT_MOVE(s)        ((grid_move_t)((s) & ((1 << PATH_MOVE_BITS) - 1)))
+#define PATH_SEGMENT_LENGTH(s)      ((long)((s) >> PATH_MOVE_BITS))
+
+/*
+ * Walks the points of a path in order, tracking both the index into grids of
+ * the maze's shape and the coordinate
+ */
+typedef struct path_iter {
+    long index;
+    coordinate_t coordinate;
+    long pointNum;         /* points returned so far */
+    long segmentNum;       /* next segment to load */
+    long numStepLeft;      /* steps left in the loaded segment */
+    grid_move_t move;
+} path_iter_t;
+
+
+/* =============================================================================
+ * path_alloc
+ * -- Encodes a traceback's points (indices into grids of gridPtr's shape, each
+ *    a grid move from the one before); gridPtr may be a window, the path is
+ *    stored in the coordinates of the whole grid
+ * =============================================================================
+ */
+path_t* path_alloc (grid_t* gridPtr, indexvector_t* pointVectorPtr);
+
+
+/* =============================================================================
+ * path_free
+ * =============================================================================
+ */
+void path_free (path_t* pathPtr);
+
+
+/* =============================================================================
+ * path_getNumPoint
+ * =============================================================================
+ */
+static inline long path_getNumPoint (path_t* pathPtr){
+    return pathPtr->numPoint;
+}
+
+
+/* =============================================================================
+ * path_getNumByte
+ * =============================================================================
+ */
+static inline long path_getNumByte (path_t* pathPtr){
+    return (long)(sizeof(path_t) + pathPtr->numSegment * sizeof(uint16_t));
+}
+
+
+/* =============================================================================
+ * path_iter_reset
+ * =============================================================================
+ */
+static inline void path_iter_reset (path_iter_t* itPtr, path_t* pathPtr){
+    itPtr->pointNum = 0;
+    itPtr->segmentNum = 0;
+    itPtr->numStepLeft = 0;
+}
+
+
+/* =============================================================================
+ * path_iter_hasNext
+ * =============================================================================
+ */
+static inline bool_t path_iter_hasNext (path_iter_t* itPtr, path_t* pathPtr){
+    return ((itPtr->pointNum < pathPtr->numPoint) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * path_iter_next
+ * -- Moves to the next point; read it from itPtr->index and itPtr->coordinate
+ * =============================================================================
+ */
+static inline void path_iter_next (path_iter_t* itPtr, grid_t* gridPtr, path_t* pathPtr){
+    if (itPtr->pointNum++ == 0) {
+        itPtr->coordinate = pathPtr->start;
+        itPtr->index = (grid_getPointRef(gridPtr, pathPtr->start.x, pathPtr->start.y, pathPtr->start.z) -
+                        gridPtr->points);
+        return;
+    }
+
+    if (itPtr->numStepLeft == 0) {
+        uint16_t segment = pathPtr->segments[itPtr->segmentNum++];
+        itPtr->move = PATH_SEGMENT_MOVE(segment);
+        itPtr->numStepLeft = PATH_SEGMENT_LENGTH(segment);
+    }
+    itPtr->numStepLeft--;
+
+    grid_move_t move = itPtr->move;
+    itPtr->index = grid_getNeighborIndex(gridPtr, itPtr->index, move);
+    long delta = ((move >= GRID_MOVE_NEGX) ? -1 : 1);
+    switch (move) {
+        case GRID_MOVE_POSX: case GRID_MOVE_NEGX: itPtr->coordinate.x += delta; break;
+        case GRID_MOVE_POSY: case GRID_MOVE_NEGY: itPtr->coordinate.y += delta; break;
+        default:                                  itPtr->coordinate.z += delta; break;
+    }
+}
+
+
+#endif /* PATH_H */
+
+
+/* =============================================================================
+ *
+ * End of path.h
+ *
+ * =============================================================================
+ */
@@ -52,15 +52,30 @@
 
 
 #include <assert.h>
+#include <limits.h>
 #include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
+#include "akers.h"
+#include "bitwave.h"
+#include "combiner.h"
 #include "coordinate.h"
 #include "grid.h"
-#include "lib/queue.h"
+#include "lib/bucketqueue.h"
+#include "lib/heap.h"
+#include "lib/ringqueue.h"
+#include "lib/timer.h"
 #include "router.h"
+#include "lib/utility.h"
 #include "lib/vector.h"
+#include "multiwave.h"
+#include "occupancy.h"
+#include "path.h"
+#include "wavefront.h"
+#include "workpool.h"
 
 
+/* MOMENTUM_POSX + m is the momentum of grid move m */
 typedef enum momentum {
     MOMENTUM_ZERO = 0,
     MOMENTUM_POSX = 1,
@@ -72,174 +87,1505 @@ typedef enum momentum {
 } momentum_t;
 
 typedef struct point {
-    long x;
-    long y;
-    long z;
+    long index;          /* into the points of the grid */
     long value;
     momentum_t momentum;
 } point_t;
 
-point_t MOVE_POSX = { 1,  0,  0,  0, MOMENTUM_POSX};
-point_t MOVE_POSY = { 0,  1,  0,  0, MOMENTUM_POSY};
-point_t MOVE_POSZ = { 0,  0,  1,  0, MOMENTUM_POSZ};
-point_t MOVE_NEGX = {-1,  0,  0,  0, MOMENTUM_NEGX};
-point_t MOVE_NEGY = { 0, -1,  0,  0, MOMENTUM_NEGY};
-point_t MOVE_NEGZ = { 0,  0, -1,  0, MOMENTUM_NEGZ};
+static const char* expansionNames[ROUTER_NUM_EXPANSION] = {
+    [ROUTER_EXPANSION_LEE]   = "lee",
+    [ROUTER_EXPANSION_ASTAR] = "astar",
+    [ROUTER_EXPANSION_BIDIR] = "bidir",
+    [ROUTER_EXPANSION_DIAL]  = "dial",
+    [ROUTER_EXPANSION_PARALLEL] = "parallel",
+    [ROUTER_EXPANSION_BITWAVE]  = "bitwave",
+    [ROUTER_EXPANSION_BATCH]    = "batch",
+    [ROUTER_EXPANSION_AKERS]    = "akers",
+};
+
+static const char* commitNames[ROUTER_NUM_COMMIT] = {
+    [ROUTER_COMMIT_LOCK] = "lock",
+    [ROUTER_COMMIT_CAS]  = "cas",
+    [ROUTER_COMMIT_STM]  = "stm",
+    [ROUTER_COMMIT_COMBINE] = "combine",
+};
+
+/*
+ * FIFO of point indices for the lee flood
+ */
+RINGQUEUE_DEFINE(indexqueue, uint32_t)
+
+/*
+ * Inclusive box the expansion is confined to
+ */
+typedef struct window {
+    coordinate_t min;
+    coordinate_t max;
+} window_t;
+
+/*
+ * A net waiting for, or riding in, a batch
+ */
+typedef struct batch_net {
+    coordinate_t* srcPtr;
+    coordinate_t* dstPtr;
+    long margin;   /* of its window */
+    long numWiden; /* times the window was widened */
+} batch_net_t;
+
+/*
+ * Per-thread scratch used by the expansion engines and the traceback
+ */
+typedef struct workspace {
+    window_t window;
+    indexqueue_t* queuePtr;
+    heap_t* heapPtr;
+    bucketqueue_t* bucketQueuePtr;
+    bucketqueue_t* dstBucketQueuePtr; /* bidir: search grown from the destination */
+    wavefront_t* wavefrontPtr; /* parallel: helper team owned by this thread */
+    bitwave_t* bitwavePtr;
+    multiwave_t* multiwavePtr; /* batch: lanes for MULTIWAVE_NUM_LANE nets */
+    akers_t* akersPtr;
+    occupancy_t* occupancyPtr; /* akers, bitwave: read in place of a private grid */
+    coordinatevector_t* astarVectorPtr; /* astar: coordinates of the heap entries, for the estimate */
+    long meetSrcIndex;  /* bidir: last point of the half traced to the source */
+    long meetDstIndex;  /* bidir: first point of the half traced to the destination */
+    indexvector_t* meetVectorPtr; /* bidir: (src side, dst side, move cost) of each contact */
+    long meetLength;
+    indexvector_t* traceVectorPtr; /* point indices of the path being traced back */
+    uint32_t* dirtyIndices; /* lee, astar, dial, bidir: points written since the last reset */
+    long numDirty;
+    window_t dirtyWindow;   /* the window those points lie in, shell included */
+    long numCommitSeen; /* commits already replayed into the private grid */
+    long numRollbackSeen; /* occupancy rollbacks when the private grid was last refilled */
+    unsigned long* snapshotVersions; /* region versions read before the grid was last brought up to date */
+    bool_t isResumed;     /* lee: repairLabels left a wavefront in the queue; carry on from it */
+    bool_t isOverflow;    /* the last expansion stopped: a label would not fit a grid point */
+    long* wideLabels;     /* ...so doWideExpansion labels the window here instead */
+    long numWideLabel;    /* what wideLabels holds */
+    indexvector_t* repairVectorPtr; /* lee: the flood's leftovers while its labels are repaired */
+    indexvector_t* regionVectorPtr;  /* regions the path being committed crosses */
+    router_stats_t stats;
+} workspace_t;
+
+/*
+ * The bidirectional engine labels points reached from the destination with
+ * values below GRID_POINT_FULL, so both wavefronts share one private grid.
+ */
+#define BIDIR_DST_VALUE(d)     (GRID_POINT_FULL - 1 - (d))
+#define BIDIR_IS_DST_VALUE(v)  ((v) < GRID_POINT_FULL)
+
+/*
+ * With routerPtr->isPredecessorLabel set, lee and dial label a point with its
+ * value shifted up by ROUTER_PRED_SHIFT bits and the grid move that reached
+ * it in the bits below, so the traceback can step straight to the predecessor
+ * instead of comparing all six neighbors.
+ */
+#define PRED_LABEL_VALUE(l)    ((l) >> ROUTER_PRED_SHIFT)
+#define PRED_LABEL_MOVE(l)     ((grid_move_t)((l) & ((1L << ROUTER_PRED_SHIFT) - 1)))
+#define PRED_OPPOSITE_MOVE(m)  ((grid_move_t)(((m) + 3) % GRID_NUM_MOVE))
+
+
+/* =============================================================================
+ * router_alloc
+ * =============================================================================
+ */
+router_t* router_alloc (long xCost, long yCost, long zCost, long bendCost){
+    router_t* routerPtr;
+
+    routerPtr = (router_t*)malloc(sizeof(router_t));
+    if (routerPtr) {
+        routerPtr->xCost = xCost;
+        routerPtr->yCost = yCost;
+        routerPtr->zCost = zCost;
+        routerPtr->bendCost = bendCost;
+        routerPtr->expansion = ROUTER_EXPANSION_LEE;
+        routerPtr->windowMargin = -1;
+        routerPtr->numExpansionThread = 2;
+        routerPtr->isPredecessorLabel = FALSE;
+        routerPtr->maxPrivateByte = 0;
+        routerPtr->commit = ROUTER_COMMIT_LOCK;
+        routerPtr->isRepairing = FALSE;
+        memset(&routerPtr->stats, 0, sizeof(router_stats_t));
+    }
+
+    return routerPtr;
+}
+
+
+/* =============================================================================
+ * router_free
+ * =============================================================================
+ */
+void router_free (router_t* routerPtr){
+    free(routerPtr);
+}
+
+
+/* =============================================================================
+ * router_parseExpansion
+ * -- Returns FALSE if 'name' is not a known expansion engine
+ * =============================================================================
+ */
+bool_t router_parseExpansion (const char* name, router_expansion_t* expansionPtr){
+    long e;
+    for (e = 0; e < ROUTER_NUM_EXPANSION; e++) {
+        if (strcmp(name, expansionNames[e]) == 0) {
+            *expansionPtr = (router_expansion_t)e;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+
+/* =============================================================================
+ * router_getExpansionName
+ * =============================================================================
+ */
+const char* router_getExpansionName (router_expansion_t expansion){
+    return expansionNames[expansion];
+}
+
+
+/* =============================================================================
+ * router_parseCommit
+ * =============================================================================
+ */
+bool_t router_parseCommit (const char* name, router_commit_t* commitPtr){
+    long c;
+    for (c = 0; c < ROUTER_NUM_COMMIT; c++) {
+        if (strcmp(name, commitNames[c]) == 0) {
+            *commitPtr = (router_commit_t)c;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+
+/* =============================================================================
+ * router_getCommitName
+ * =============================================================================
+ */
+const char* router_getCommitName (router_commit_t commit){
+    return commitNames[commit];
+}
+
+
+/* =============================================================================
+ * router_isCommitSupported
+ * =============================================================================
+ */
+bool_t router_isCommitSupported (router_commit_t commit){
+    return ((commit != ROUTER_COMMIT_STM || occupancy_isTransactionSupported()) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * router_isPredecessorSupported
+ * =============================================================================
+ */
+bool_t router_isPredecessorSupported (router_expansion_t expansion){
+    return ((expansion == ROUTER_EXPANSION_LEE ||
+             expansion == ROUTER_EXPANSION_DIAL) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * router_isRepairSupported
+ * -- The repair resumes a FIFO flood, which settles labels in any order
+ * =============================================================================
+ */
+bool_t router_isRepairSupported (router_expansion_t expansion){
+    return ((expansion == ROUTER_EXPANSION_LEE) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * router_isWindowGridSupported
+ * -- batch floods the whole grid for many nets at once; akers and bitwave
+ *    keep no private grid of this kind
+ * =============================================================================
+ */
+bool_t router_isWindowGridSupported (router_expansion_t expansion){
+    return ((expansion != ROUTER_EXPANSION_BATCH &&
+             expansion != ROUTER_EXPANSION_AKERS &&
+             expansion != ROUTER_EXPANSION_BITWAVE) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * router_printStats
+ * =============================================================================
+ */
+void router_printStats (router_t* routerPtr, FILE* file){
+    router_stats_t* statsPtr = &routerPtr->stats;
+
+    fprintf(file, "Expansion       = %s%s\n", router_getExpansionName(routerPtr->expansion),
+            (routerPtr->isPredecessorLabel ? " (predecessor labels)" : ""));
+    fprintf(file, "Cells expanded  = %li (%.1f per net)\n",
+            statsPtr->numCellExpanded,
+            ((statsPtr->numExpansion > 0) ?
+             ((double)statsPtr->numCellExpanded / (double)statsPtr->numExpansion) : 0.0));
+    fprintf(file, "Cells relabeled = %li\n", statsPtr->numCellRelabeled);
+    fprintf(file, "Stale skipped   = %li\n", statsPtr->numCellSkipped);
+    if (statsPtr->numCellReset > 0) {
+        fprintf(file, "Cells reset     = %li (%.1f per attempt)\n",
+                statsPtr->numCellReset,
+                ((double)statsPtr->numCellReset / (double)statsPtr->numExpansion));
+    }
+    if (routerPtr->isRepairing) {
+        fprintf(file, "Repairs         = %li lost commits (%li labels kept, %li cells re-expanded)\n",
+                statsPtr->numRepair, statsPtr->numCellKept, statsPtr->numCellReexpanded);
+    }
+    double routeSeconds = statsPtr->expansionSeconds + statsPtr->tracebackSeconds;
+    fprintf(file, "Traceback share = %.1f%% (%.3f of %.3f thread-seconds)\n",
+            ((routeSeconds > 0.0) ? (100.0 * statsPtr->tracebackSeconds / routeSeconds) : 0.0),
+            statsPtr->tracebackSeconds, routeSeconds);
+    long numCommitCall = statsPtr->numCommitted + statsPtr->numConflict;
+    fprintf(file, "Commit          = %s: %li paths, %li conflicts, %.6f thread-seconds (%.1f per ms)\n",
+            router_getCommitName(routerPtr->commit),
+            statsPtr->numCommitted, statsPtr->numConflict, statsPtr->commitSeconds,
+            ((statsPtr->commitSeconds > 0.0) ?
+             ((double)numCommitCall / (1000.0 * statsPtr->commitSeconds)) : 0.0));
+    long lastBucket = 0;
+    long b;
+    for (b = 0; b < ROUTER_NUM_LATENCY_BUCKET; b++) {
+        if (statsPtr->numCommitLatency[b] > 0) {
+            lastBucket = b;
+        }
+    }
+    fprintf(file, "Commit latency  =");
+    for (b = 0; b <= lastBucket; b++) {
+        if (b == ROUTER_NUM_LATENCY_BUCKET - 1) {
+            fprintf(file, " more:%li", statsPtr->numCommitLatency[b]);
+        } else {
+            fprintf(file, " <%lius:%li", (1L << b), statsPtr->numCommitLatency[b]);
+        }
+    }
+    long median = 0;
+    long p99 = 0;
+    long numSeen = 0;
+    for (b = 0; b <= lastBucket; b++) {
+        numSeen += statsPtr->numCommitLatency[b];
+        if (2 * numSeen < numCommitCall) {
+            median = b + 1;
+        }
+        if (100 * numSeen < 99 * numCommitCall) {
+            p99 = b + 1;
+        }
+    }
+    fprintf(file, " (median <%lius, 99%% <%lius)\n", (1L << median), (1L << p99));
+    fprintf(file, "Snapshots       = %li commits unvalidated, %li restarted before committing\n",
+            statsPtr->numUnvalidated, statsPtr->numEarlyRestart);
+    if (routerPtr->commit == ROUTER_COMMIT_STM) {
+        long numAbort = statsPtr->numAttempt - numCommitCall;
+        fprintf(file, "Aborts          = %li (%.1f%% of transaction runs)\n", numAbort,
+                ((statsPtr->numAttempt > 0) ? (100.0 * numAbort / statsPtr->numAttempt) : 0.0));
+    }
+    if (routerPtr->expansion == ROUTER_EXPANSION_PARALLEL) {
+        fprintf(file, "Expansion team  = %li threads per net\n", routerPtr->numExpansionThread);
+        fprintf(file, "Levels          = %li\n", statsPtr->numLevel);
+    } else if (routerPtr->expansion == ROUTER_EXPANSION_BITWAVE) {
+        fprintf(file, "Kernel          = %s\n", bitwave_getKernelName());
+        fprintf(file, "Waves           = %li\n", statsPtr->numLevel);
+    } else if (routerPtr->expansion == ROUTER_EXPANSION_BATCH) {
+        fprintf(file, "Batches         = %li (%.1f nets per batch)\n",
+                statsPtr->numBatch,
+                ((statsPtr->numBatch > 0) ?
+                 ((double)statsPtr->numExpansion / (double)statsPtr->numBatch) : 0.0));
+        fprintf(file, "Waves           = %li\n", statsPtr->numLevel);
+    }
+    fprintf(file, "Private grid    = %li bytes peak per thread\n", statsPtr->numPrivateByte);
+    if (routerPtr->maxPrivateByte > 0) {
+        fprintf(file, "Memory ceiling  = %li bytes per thread (%li nets left unrouted under it)\n",
+                routerPtr->maxPrivateByte, statsPtr->numOverCeiling);
+    }
+
+    if (statsPtr->numWideRetry > 0) {
+        fprintf(file, "Wide labels     = %li expansions redone (%i-bit grid points overflowed)\n",
+                statsPtr->numWideRetry, GRID_POINT_BITS);
+    }
+
+    if (routerPtr->windowMargin >= 0 || routerPtr->maxPrivateByte > 0 ||
+        routerPtr->expansion == ROUTER_EXPANSION_BATCH)
+    {
+        long w;
+        long lastStep = 0;
+        for (w = 0; w < ROUTER_MAX_WINDOW_STEP; w++) {
+            if (statsPtr->numWindowStep[w] > 0) {
+                lastStep = w;
+            }
+        }
+        fprintf(file, "Window margin   = %li\n",
+                ((routerPtr->expansion == ROUTER_EXPANSION_BATCH && routerPtr->windowMargin < 0) ?
+                 (long)ROUTER_BATCH_MARGIN : routerPtr->windowMargin));
+        fprintf(file, "Window widening =");
+        for (w = 0; w <= lastStep; w++) {
+            fprintf(file, " %li:%li", w, statsPtr->numWindowStep[w]);
+        }
+        fprintf(file, " (widenings: nets)\n");
+    }
+}
+
+
+/* =============================================================================
+ * addStats
+ * =============================================================================
+ */
+static void addStats (router_stats_t* dstPtr, router_stats_t* srcPtr){
+    dstPtr->numExpansion     += srcPtr->numExpansion;
+    dstPtr->numCellExpanded  += srcPtr->numCellExpanded;
+    dstPtr->numCellRelabeled += srcPtr->numCellRelabeled;
+    dstPtr->numCellSkipped   += srcPtr->numCellSkipped;
+    dstPtr->numCellReset     += srcPtr->numCellReset;
+    dstPtr->numRepair        += srcPtr->numRepair;
+    dstPtr->numCellKept      += srcPtr->numCellKept;
+    dstPtr->numCellReexpanded += srcPtr->numCellReexpanded;
+    long w;
+    for (w = 0; w < ROUTER_MAX_WINDOW_STEP; w++) {
+        dstPtr->numWindowStep[w] += srcPtr->numWindowStep[w];
+    }
+    dstPtr->numLevel         += srcPtr->numLevel;
+    dstPtr->numBatch         += srcPtr->numBatch;
+    dstPtr->numPrivateByte    = MAX(dstPtr->numPrivateByte, srcPtr->numPrivateByte);
+    dstPtr->numOverCeiling   += srcPtr->numOverCeiling;
+    dstPtr->numWideRetry     += srcPtr->numWideRetry;
+    dstPtr->numCommitted     += srcPtr->numCommitted;
+    dstPtr->numConflict      += srcPtr->numConflict;
+    dstPtr->numAttempt       += srcPtr->numAttempt;
+    dstPtr->numUnvalidated   += srcPtr->numUnvalidated;
+    dstPtr->numEarlyRestart  += srcPtr->numEarlyRestart;
+    for (w = 0; w < ROUTER_NUM_LATENCY_BUCKET; w++) {
+        dstPtr->numCommitLatency[w] += srcPtr->numCommitLatency[w];
+    }
+    dstPtr->commitSeconds    += srcPtr->commitSeconds;
+    dstPtr->expansionSeconds += srcPtr->expansionSeconds;
+    dstPtr->tracebackSeconds += srcPtr->tracebackSeconds;
+}
+
+
+/* =============================================================================
+ * setWindow
+ * -- Bounding box of src and dst grown by 'margin' on every side and clipped
+ *    to the grid; a negative margin selects the whole grid
+ * =============================================================================
+ */
+static void setWindow (window_t* windowPtr, grid_t* gridPtr, coordinate_t* srcPtr, coordinate_t* dstPtr, long margin){
+    if (margin < 0) {
+        margin = LONG_MAX / 2;
+    }
+
+    windowPtr->min.x = MAX(MIN(srcPtr->x, dstPtr->x) - margin, 0L);
+    windowPtr->max.x = MIN(MAX(srcPtr->x, dstPtr->x) + margin, gridPtr->width - 1);
+    windowPtr->min.y = MAX(MIN(srcPtr->y, dstPtr->y) - margin, 0L);
+    windowPtr->max.y = MIN(MAX(srcPtr->y, dstPtr->y) + margin, gridPtr->height - 1);
+    windowPtr->min.z = MAX(MIN(srcPtr->z, dstPtr->z) - margin, 0L);
+    windowPtr->max.z = MIN(MAX(srcPtr->z, dstPtr->z) + margin, gridPtr->depth - 1);
+}
+
+
+/* =============================================================================
+ * isWindowWholeGrid
+ * =============================================================================
+ */
+static bool_t isWindowWholeGrid (window_t* windowPtr, grid_t* gridPtr){
+    return ((windowPtr->min.x == 0 && windowPtr->max.x == gridPtr->width - 1 &&
+             windowPtr->min.y == 0 && windowPtr->max.y == gridPtr->height - 1 &&
+             windowPtr->min.z == 0 && windowPtr->max.z == gridPtr->depth - 1) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * markDirty
+ * -- Logs a point about to be written so resetWindow can restore it. Only
+ *    EMPTY points are logged as they are labelled, and a point turns EMPTY
+ *    again only if it is the destination or repairLabels clears it (and
+ *    drops it from the list), so an attempt logs at most numPoint + 1
+ *    points and the list never overflows.
+ * =============================================================================
+ */
+static inline void markDirty (workspace_t* workspacePtr, long index){
+    workspacePtr->dirtyIndices[workspacePtr->numDirty++] = (uint32_t)index;
+}
+
+
+/* =============================================================================
+ * wallWindow
+ * -- Writes GRID_POINT_FULL to the shell of points around the window (the
+ *    grid's own border at its edges), so expansion and traceback never step
+ *    out of it; logs each point in the workspace's dirty list if given one
+ * =============================================================================
+ */
+static void wallWindow (grid_t* myGridPtr, window_t* windowPtr, workspace_t* workspacePtr){
+    coordinate_t* minPtr = &windowPtr->min;
+    coordinate_t* maxPtr = &windowPtr->max;
+    long x;
+    long y;
+    long z;
+
+    for (z = minPtr->z - 1; z <= maxPtr->z + 1; z++) {
+        for (y = minPtr->y - 1; y <= maxPtr->y + 1; y++) {
+            bool_t isFace = ((z < minPtr->z || z > maxPtr->z || y < minPtr->y || y > maxPtr->y) ?
+                             TRUE : FALSE);
+            long step = (isFace ? 1 : (maxPtr->x - minPtr->x + 2));
+            for (x = minPtr->x - 1; x <= maxPtr->x + 1; x += step) {
+                grid_point_t* gridPointPtr = grid_getPointRef(myGridPtr, x, y, z);
+                *gridPointPtr = GRID_POINT_FULL;
+                if (workspacePtr) {
+                    markDirty(workspacePtr, (gridPointPtr - myGridPtr->points));
+                }
+            }
+        }
+    }
+}
+
+
+/* =============================================================================
+ * fillWindow
+ * -- Rebuilds myGridPtr from the shared occupancy over the window and walls
+ *    it in. Points beyond keep stale labels from earlier nets and are never
+ *    read.
+ * =============================================================================
+ */
+static void fillWindow (occupancy_t* occupancyPtr, grid_t* myGridPtr, window_t* windowPtr){
+    occupancy_fillGrid(occupancyPtr, myGridPtr, &windowPtr->min, &windowPtr->max);
+    wallWindow(myGridPtr, windowPtr, NULL);
+}
+
+
+/* =============================================================================
+ * resetWindow
+ * -- Same result as fillWindow for the engines that log what they write:
+ *    only the points the last attempt dirtied are restored from the shared
+ *    occupancy, and only the paths committed since are replayed, so the cost
+ *    follows the explored area rather than the window. No stale labels are
+ *    left anywhere.
+ * -- A flood that dirtied most of its window is cheaper to undo a word of
+ *    occupancy bits at a time, so past ROUTER_DIRTY_DENSITY that window is
+ *    refilled instead
+ * =============================================================================
+ */
+static void resetWindow (occupancy_t* occupancyPtr, grid_t* myGridPtr, workspace_t* workspacePtr){
+    window_t* dirtyWindowPtr = &workspacePtr->dirtyWindow;
+    coordinate_t* minPtr = &dirtyWindowPtr->min;
+    coordinate_t* maxPtr = &dirtyWindowPtr->max;
+    long numDirty = workspacePtr->numDirty;
+    long volume = ((maxPtr->x - minPtr->x + 1) *
+                   (maxPtr->y - minPtr->y + 1) *
+                   (maxPtr->z - minPtr->z + 1));
+
+    long numRollback = occupancy_getNumRollback(occupancyPtr);
+    if (numRollback != workspacePtr->numRollbackSeen) {
+        /* A claim rolled back since may have left a stale full point anywhere */
+        coordinate_t gridMin = { 0, 0, 0 };
+        coordinate_t gridMax = { myGridPtr->width - 1, myGridPtr->height - 1, myGridPtr->depth - 1 };
+        occupancy_fillGrid(occupancyPtr, myGridPtr, &gridMin, &gridMax);
+        workspacePtr->stats.numCellReset += myGridPtr->width * myGridPtr->height * myGridPtr->depth;
+        workspacePtr->numRollbackSeen = numRollback;
+    } else if (numDirty * ROUTER_DIRTY_DENSITY > volume) {
+        occupancy_fillGrid(occupancyPtr, myGridPtr, minPtr, maxPtr);
+        workspacePtr->stats.numCellReset += volume;
+    } else {
+        occupancy_resetPoints(occupancyPtr, myGridPtr, workspacePtr->dirtyIndices, numDirty);
+        workspacePtr->stats.numCellReset += numDirty;
+    }
+    workspacePtr->numDirty = 0;
+    occupancy_syncGrid(occupancyPtr, myGridPtr, &workspacePtr->numCommitSeen, NULL);
+
+    /* The shell is dirtied too, so grow the window by it (the border stays full) */
+    window_t* windowPtr = &workspacePtr->window;
+    if (!isWindowWholeGrid(windowPtr, myGridPtr)) {
+        wallWindow(myGridPtr, windowPtr, workspacePtr);
+    }
+    minPtr->x = MAX(windowPtr->min.x - 1, 0L);
+    minPtr->y = MAX(windowPtr->min.y - 1, 0L);
+    minPtr->z = MAX(windowPtr->min.z - 1, 0L);
+    maxPtr->x = MIN(windowPtr->max.x + 1, myGridPtr->width - 1);
+    maxPtr->y = MIN(windowPtr->max.y + 1, myGridPtr->height - 1);
+    maxPtr->z = MIN(windowPtr->max.z + 1, myGridPtr->depth - 1);
+}
+
+
+/* =============================================================================
+ * fitWindow
+ * -- Sets the window to the widest margin in [minMargin, maxMargin] whose
+ *    grid holds at most maxPoint points, and returns it; -1 if none does
+ * =============================================================================
+ */
+static long fitWindow (window_t* windowPtr, grid_t* gridPtr, coordinate_t* srcPtr, coordinate_t* dstPtr, long minMargin, long maxMargin, long maxPoint){
+    long margin = -1;
+
+    while (minMargin <= maxMargin) {
+        long m = minMargin + (maxMargin - minMargin) / 2;
+        setWindow(windowPtr, gridPtr, srcPtr, dstPtr, m);
+        if (grid_getNumPoint((windowPtr->max.x - windowPtr->min.x + 1),
+                             (windowPtr->max.y - windowPtr->min.y + 1),
+                             (windowPtr->max.z - windowPtr->min.z + 1)) <= maxPoint)
+        {
+            margin = m;
+            minMargin = m + 1;
+        } else {
+            maxMargin = m - 1;
+        }
+    }
+    if (margin >= 0) {
+        setWindow(windowPtr, gridPtr, srcPtr, dstPtr, margin);
+    }
+
+    return margin;
+}
+
+
+/* =============================================================================
+ * isDirtyLogged
+ * -- Engines whose every write to the private grid is logged by markDirty,
+ *    so resetWindow can stand in for fillWindow
+ * =============================================================================
+ */
+static bool_t isDirtyLogged (router_expansion_t expansion){
+    return ((expansion == ROUTER_EXPANSION_LEE   ||
+             expansion == ROUTER_EXPANSION_ASTAR ||
+             expansion == ROUTER_EXPANSION_DIAL  ||
+             expansion == ROUTER_EXPANSION_BIDIR) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * getLabelSteps
+ * -- What each grid move adds to the label of the point it leaves: the move's
+ *    cost, shifted up with the move itself below it for predecessor labels
+ *    ('labelShift' of ROUTER_PRED_SHIFT rather than 0)
+ * =============================================================================
+ */
+static inline void getLabelSteps (router_t* routerPtr, long labelShift, long steps[GRID_NUM_MOVE]){
+    long costs[GRID_NUM_MOVE];
+    costs[GRID_MOVE_POSX] = costs[GRID_MOVE_NEGX] = routerPtr->xCost;
+    costs[GRID_MOVE_POSY] = costs[GRID_MOVE_NEGY] = routerPtr->yCost;
+    costs[GRID_MOVE_POSZ] = costs[GRID_MOVE_NEGZ] = routerPtr->zCost;
+
+    long m;
+    for (m = 0; m < GRID_NUM_MOVE; m++) {
+        steps[m] = ((costs[m] << labelShift) | ((labelShift > 0) ? m : 0));
+    }
+}
+
+
+/* =============================================================================
+ * getMaxExpandValue
+ * -- Largest label a point can be expanded from before one of its neighbors'
+ *    labels would outgrow a grid point
+ * =============================================================================
+ */
+static inline long getMaxExpandValue (long steps[GRID_NUM_MOVE]){
+    long maxStep = 0;
+    long m;
+    for (m = 0; m < GRID_NUM_MOVE; m++) {
+        maxStep = MAX(maxStep, steps[m]);
+    }
+
+    return ((long)GRID_POINT_MAX - maxStep);
+}
+
+
+/* =============================================================================
+ * expandToNeighbor
+ * -- No window test: fillWindow walls the window in
+ * -- 'tieMask' covers the move bits of predecessor labels (else 0), so a
+ *    point reached again at the same value keeps its first predecessor
+ * -- Logs newly labelled points at *dirtyPtrPtr, a register copy of the
+ *    markDirty cursor
+ * =============================================================================
+ */
+static inline void expandToNeighbor (grid_point_t* points, long neighborIndex, workspace_t* workspacePtr, long value, long tieMask, uint32_t** dirtyPtrPtr){
+    long neighborValue = points[neighborIndex];
+    if (neighborValue == GRID_POINT_EMPTY) {
+        *(*dirtyPtrPtr)++ = (uint32_t)neighborIndex;
+        points[neighborIndex] = value;
+        indexqueue_push(workspacePtr->queuePtr, (uint32_t)neighborIndex);
+    } else if (neighborValue != GRID_POINT_FULL) {
+        /* We have expanded here before... is this new path better? */
+        if ((value | tieMask) < neighborValue) {
+            points[neighborIndex] = value;
+            indexqueue_push(workspacePtr->queuePtr, (uint32_t)neighborIndex);
+            workspacePtr->stats.numCellRelabeled++;
+        }
+    }
+}
+
+
+/* =============================================================================
+ * leeExpand
+ * -- Inlined once per 'labelShift', so plain labels pay nothing for the
+ *    predecessor bits
+ * =============================================================================
+ */
+static inline __attribute__((always_inline))
+bool_t leeExpand (router_t* routerPtr, grid_t* myGridPtr, workspace_t* workspacePtr, coordinate_t* srcPtr, coordinate_t* dstPtr, long labelShift){
+    indexqueue_t* queuePtr = workspacePtr->queuePtr;
+    grid_point_t* points = myGridPtr->points;
+    long moveMask = (1L << labelShift) - 1;
+    long steps[GRID_NUM_MOVE];
+    getLabelSteps(routerPtr, labelShift, steps);
+    long maxValue = getMaxExpandValue(steps);
+
+    /*
+     * Potential Optimization: Make 'src' the one closest to edge.
+     * This will likely decrease the area of the emitted wave.
+     */
+
+    long dstIndex = grid_getPointRef(myGridPtr, dstPtr->x, dstPtr->y, dstPtr->z) - points;
+    if (workspacePtr->isResumed) {
+        /* repairLabels queued the wavefront; the destination is cleared */
+        workspacePtr->isResumed = FALSE;
+    } else {
+        indexqueue_clear(queuePtr);
+        long srcIndex = grid_getPointRef(myGridPtr, srcPtr->x, srcPtr->y, srcPtr->z) - points;
+        indexqueue_push(queuePtr, (uint32_t)srcIndex);
+        markDirty(workspacePtr, srcIndex);
+        points[srcIndex] = (GRID_POINT_ORIGIN << labelShift);
+        markDirty(workspacePtr, dstIndex);
+        points[dstIndex] = GRID_POINT_EMPTY;
+    }
+    bool_t isPathFound = FALSE;
+    uint32_t* dirtyPtr = &workspacePtr->dirtyIndices[workspacePtr->numDirty];
+
+    while (!indexqueue_isEmpty(queuePtr)) {
+
+        long index = indexqueue_pop(queuePtr);
+        if (index == dstIndex) {
+            isPathFound = TRUE;
+            break;
+        }
+
+        long value = points[index] & ~moveMask;
+        if (value > maxValue) {
+            workspacePtr->isOverflow = TRUE;
+            break;
+        }
+        workspacePtr->stats.numCellExpanded++;
+
+        /*
+         * Check 6 neighbors
+         *
+         * Potential Optimization: Only need to check 5 of these
+         */
+        expandToNeighbor(points, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_POSX), workspacePtr, (value + steps[GRID_MOVE_POSX]), moveMask, &dirtyPtr);
+        expandToNeighbor(points, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_NEGX), workspacePtr, (value + steps[GRID_MOVE_NEGX]), moveMask, &dirtyPtr);
+        expandToNeighbor(points, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_POSY), workspacePtr, (value + steps[GRID_MOVE_POSY]), moveMask, &dirtyPtr);
+        expandToNeighbor(points, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_NEGY), workspacePtr, (value + steps[GRID_MOVE_NEGY]), moveMask, &dirtyPtr);
+        expandToNeighbor(points, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_POSZ), workspacePtr, (value + steps[GRID_MOVE_POSZ]), moveMask, &dirtyPtr);
+        expandToNeighbor(points, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_NEGZ), workspacePtr, (value + steps[GRID_MOVE_NEGZ]), moveMask, &dirtyPtr);
+
+    } /* iterate over work queue */
+
+    workspacePtr->numDirty = dirtyPtr - workspacePtr->dirtyIndices;
+
+    return isPathFound;
+}
+
+
+/* =============================================================================
+ * doLeeExpansion
+ * =============================================================================
+ */
+static bool_t doLeeExpansion (router_t* routerPtr, grid_t* myGridPtr, workspace_t* workspacePtr, coordinate_t* srcPtr, coordinate_t* dstPtr){
+    if (routerPtr->isPredecessorLabel) {
+        return leeExpand(routerPtr, myGridPtr, workspacePtr, srcPtr, dstPtr, ROUTER_PRED_SHIFT);
+    }
+    return leeExpand(routerPtr, myGridPtr, workspacePtr, srcPtr, dstPtr, 0);
+}
+
+
+/* =============================================================================
+ * isLabelSupported
+ * -- TRUE if the label at 'index' is still the length of some path through
+ *    labelled points: its recorded predecessor is labelled, or without
+ *    predecessor labels some labelled neighbor is at least a step shorter
+ * =============================================================================
+ */
+static bool_t isLabelSupported (grid_t* myGridPtr, long index, long steps[GRID_NUM_MOVE], long labelShift){
+    grid_point_t* points = myGridPtr->points;
+    long label = points[index];
+    if (labelShift > 0) {
+        grid_move_t move = PRED_OPPOSITE_MOVE(PRED_LABEL_MOVE(label));
+        return ((points[grid_getNeighborIndex(myGridPtr, index, move)] > GRID_POINT_EMPTY) ?
+                TRUE : FALSE);
+    }
+    long m;
+    for (m = 0; m < GRID_NUM_MOVE; m++) {
+        /* A move costs the same both ways */
+        long neighborValue = points[grid_getNeighborIndex(myGridPtr, index, (grid_move_t)m)];
+        if (neighborValue > GRID_POINT_EMPTY && (neighborValue + steps[m]) <= label) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+
+/* =============================================================================
+ * addNeighborLabels
+ * -- Queues the labelled neighbors of 'index' for repairLabels to recheck,
+ *    smallest label first
+ * =============================================================================
+ */
+static void addNeighborLabels (grid_t* myGridPtr, heap_t* heapPtr, long index){
+    grid_point_t* points = myGridPtr->points;
+    long m;
+    for (m = 0; m < GRID_NUM_MOVE; m++) {
+        long neighborIndex = grid_getNeighborIndex(myGridPtr, index, (grid_move_t)m);
+        if (points[neighborIndex] > GRID_POINT_EMPTY) {
+            bool_t status = heap_insert(heapPtr, points[neighborIndex], (void*)(uintptr_t)neighborIndex);
+            assert(status);
+        }
+    }
+}
+
+
+/* =============================================================================
+ * repairLabels
+ * -- After a lost commit, replays the paths committed since the expansion
+ *    and clears only the labels downstream of the points they took and of
+ *    the path the traceback overwrote: in label order, a label goes if no
+ *    labelled neighbor still supports it, and its neighbors are rechecked.
+ *    Steps cost more than nothing, so supports never go round in circles.
+ * -- Leaves in the queue the surviving labels next to cleared points, then
+ *    the flood's unexpanded leftovers; leeExpand carries on from there
+ * -- Returns FALSE if a rollback may have left stale full points; the grid
+ *    is then reset as usual
+ * =============================================================================
+ */
+static bool_t repairLabels (router_t* routerPtr, occupancy_t* occupancyPtr, grid_t* myGridPtr, workspace_t* workspacePtr, coordinate_t* srcPtr){
+    if (occupancy_getNumRollback(occupancyPtr) != workspacePtr->numRollbackSeen) {
+        return FALSE;
+    }
+
+    long labelShift = (routerPtr->isPredecessorLabel ? ROUTER_PRED_SHIFT : 0);
+    long steps[GRID_NUM_MOVE];
+    getLabelSteps(routerPtr, labelShift, steps);
+    grid_point_t* points = myGridPtr->points;
+    indexqueue_t* queuePtr = workspacePtr->queuePtr;
+    heap_t* heapPtr = workspacePtr->heapPtr;
+    indexvector_t* repairVectorPtr = workspacePtr->repairVectorPtr;
+    indexvector_t* traceVectorPtr = workspacePtr->traceVectorPtr;
+
+    /* The traceback wrote the lost path over its labels, destination included */
+    indexvector_clear(repairVectorPtr);
+    long numTrace = indexvector_getSize(traceVectorPtr);
+    long t;
+    for (t = 0; t < numTrace; t++) {
+        uint32_t index = *indexvector_at(traceVectorPtr, t);
+        points[index] = GRID_POINT_EMPTY;
+        bool_t status = indexvector_pushBack(repairVectorPtr, index);
+        assert(status);
+    }
+    long srcIndex = grid_getPointRef(myGridPtr, srcPtr->x, srcPtr->y, srcPtr->z) - points;
+    points[srcIndex] = (GRID_POINT_ORIGIN << labelShift);
+
+    occupancy_readVersions(occupancyPtr, workspacePtr->snapshotVersions);
+    occupancy_syncGrid(occupancyPtr, myGridPtr, &workspacePtr->numCommitSeen, repairVectorPtr);
+
+    heap_clear(heapPtr);
+    long numDamage = indexvector_getSize(repairVectorPtr);
+    long d;
+    for (d = 0; d < numDamage; d++) {
+        addNeighborLabels(myGridPtr, heapPtr, *indexvector_at(repairVectorPtr, d));
+    }
+
+    indexvector_clear(repairVectorPtr);
+    while (!indexqueue_isEmpty(queuePtr)) {
+        bool_t status = indexvector_pushBack(repairVectorPtr, indexqueue_pop(queuePtr));
+        assert(status);
+    }
+
+    while (!heap_isEmpty(heapPtr)) {
+        long label;
+        long index = (long)(uintptr_t)heap_remove(heapPtr, &label);
+        if (points[index] != label) {
+            continue; /* cleared since it was queued */
+        }
+        if (index == srcIndex || isLabelSupported(myGridPtr, index, steps, labelShift)) {
+            indexqueue_push(queuePtr, (uint32_t)index);
+        } else {
+            points[index] = GRID_POINT_EMPTY;
+            addNeighborLabels(myGridPtr, heapPtr, index);
+        }
+    }
+
+    long numLeftover = indexvector_getSize(repairVectorPtr);
+    long l;
+    for (l = 0; l < numLeftover; l++) {
+        uint32_t index = *indexvector_at(repairVectorPtr, l);
+        if (points[index] > GRID_POINT_EMPTY) {
+            indexqueue_push(queuePtr, index);
+        }
+    }
+
+    /*
+     * Cleared points are EMPTY again, as before they were labelled, so they
+     * leave the dirty list; the destination keeps one entry as it was full
+     */
+    long dstIndex = *indexvector_at(traceVectorPtr, 0);
+    bool_t isDstLogged = FALSE;
+    uint32_t* dirtyIndices = workspacePtr->dirtyIndices;
+    long numDirty = 0;
+    long numKept = 0;
+    for (d = 0; d < workspacePtr->numDirty; d++) {
+        uint32_t index = dirtyIndices[d];
+        if (index == dstIndex) {
+            if (isDstLogged) {
+                continue;
+            }
+            isDstLogged = TRUE;
+        } else if (points[index] == GRID_POINT_EMPTY) {
+            continue;
+        } else if (points[index] > GRID_POINT_EMPTY) {
+            numKept++;
+        }
+        dirtyIndices[numDirty++] = index;
+    }
+    workspacePtr->numDirty = numDirty;
+
+    workspacePtr->stats.numRepair++;
+    workspacePtr->stats.numCellKept += numKept;
+    workspacePtr->isResumed = TRUE;
+
+    return TRUE;
+}
+
+
+/* =============================================================================
+ * ASTAR_KEY
+ * -- Orders by f = g + h; among equal f, the deeper point (larger g) comes
+ *    first so the search runs straight at the destination instead of filling
+ *    every point of equal estimate.
+ * =============================================================================
+ */
+#define ASTAR_KEY(f, g) (((f) << 32) - (g))
+
+
+/* =============================================================================
+ * getAStarEstimate
+ * -- Cost-weighted Manhattan distance: admissible and consistent since every
+ *    move changes exactly one coordinate by one unit at that axis' cost
+ * =============================================================================
+ */
+static inline long getAStarEstimate (router_t* routerPtr, long x, long y, long z, coordinate_t* dstPtr){
+    long dx = labs(x - dstPtr->x);
+    long dy = labs(y - dstPtr->y);
+    long dz = labs(z - dstPtr->z);
+
+    return (dx * routerPtr->xCost + dy * routerPtr->yCost + dz * routerPtr->zCost);
+}
+
+
+/*
+ * A heap entry of the A* search: the point's index, and where its coordinates
+ * are in the workspace's astarVectorPtr
+ */
+#define ASTAR_DATA(i, c)         ((void*)(((uintptr_t)(c) << 32) | (uint32_t)(i)))
+#define ASTAR_DATA_INDEX(d)      ((long)(uint32_t)(uintptr_t)(d))
+#define ASTAR_DATA_COORDINATE(d) ((long)((uintptr_t)(d) >> 32))
+
+
+/* =============================================================================
+ * pushAStar
+ * =============================================================================
+ */
+static inline void pushAStar (router_t* routerPtr, workspace_t* workspacePtr, long index, long x, long y, long z, long value, coordinate_t* dstPtr){
+    coordinatevector_t* astarVectorPtr = workspacePtr->astarVectorPtr;
+    long c = coordinatevector_getSize(astarVectorPtr);
+    assert(c <= (long)UINT32_MAX);
+    coordinate_t coordinate = { x, y, z };
+    bool_t status = coordinatevector_pushBack(astarVectorPtr, coordinate);
+    assert(status);
+    long f = value + getAStarEstimate(routerPtr, x, y, z, dstPtr);
+    status = heap_insert(workspacePtr->heapPtr, ASTAR_KEY(f, value), ASTAR_DATA(index, c));
+    assert(status);
+}
+
+
+/* =============================================================================
+ * expandToNeighborAStar
+ * -- No window test: fillWindow walls the window in. The coordinates only
+ *    feed the estimate.
+ * =============================================================================
+ */
+static inline void expandToNeighborAStar (router_t* routerPtr, grid_point_t* points, workspace_t* workspacePtr, long neighborIndex, long x, long y, long z, long value, coordinate_t* dstPtr){
+    long neighborValue = points[neighborIndex];
+    if (neighborValue == GRID_POINT_EMPTY ||
+        (neighborValue != GRID_POINT_FULL && value < neighborValue))
+    {
+        if (neighborValue != GRID_POINT_EMPTY) {
+            workspacePtr->stats.numCellRelabeled++;
+        } else {
+            markDirty(workspacePtr, neighborIndex);
+        }
+        points[neighborIndex] = value;
+        pushAStar(routerPtr, workspacePtr, neighborIndex, x, y, z, value, dstPtr);
+    }
+}
+
+
+/* =============================================================================
+ * doAStarExpansion
+ * -- Leaves the same value field as doLeeExpansion on every point it labels,
+ *    so doTraceback works unchanged; points far from the src-dst corridor are
+ *    simply left EMPTY.
+ * =============================================================================
+ */
+static bool_t doAStarExpansion (router_t* routerPtr, grid_t* myGridPtr, workspace_t* workspacePtr, coordinate_t* srcPtr, coordinate_t* dstPtr){
+    heap_t* heapPtr = workspacePtr->heapPtr;
+    coordinatevector_t* astarVectorPtr = workspacePtr->astarVectorPtr;
+    router_stats_t* statsPtr = &workspacePtr->stats;
+    grid_point_t* points = myGridPtr->points;
+    long xCost = routerPtr->xCost;
+    long yCost = routerPtr->yCost;
+    long zCost = routerPtr->zCost;
+    long maxValue = (long)GRID_POINT_MAX - MAX(xCost, MAX(yCost, zCost));
+
+    heap_clear(heapPtr);
+    coordinatevector_clear(astarVectorPtr);
+    long srcIndex = grid_getPointRef(myGridPtr, srcPtr->x, srcPtr->y, srcPtr->z) - points;
+    long dstIndex = grid_getPointRef(myGridPtr, dstPtr->x, dstPtr->y, dstPtr->z) - points;
+    pushAStar(routerPtr, workspacePtr, srcIndex, srcPtr->x, srcPtr->y, srcPtr->z, GRID_POINT_ORIGIN, dstPtr);
+    markDirty(workspacePtr, srcIndex);
+    markDirty(workspacePtr, dstIndex);
+    points[srcIndex] = GRID_POINT_ORIGIN;
+    points[dstIndex] = GRID_POINT_EMPTY;
+    bool_t isPathFound = FALSE;
+
+    while (!heap_isEmpty(heapPtr)) {
+
+        long key;
+        void* dataPtr = heap_remove(heapPtr, &key);
+        long index = ASTAR_DATA_INDEX(dataPtr);
+        if (index == dstIndex) {
+            isPathFound = TRUE;
+            break;
+        }
+
+        coordinate_t curr = *coordinatevector_at(astarVectorPtr, ASTAR_DATA_COORDINATE(dataPtr));
+        long x = curr.x;
+        long y = curr.y;
+        long z = curr.z;
+        long value = points[index];
+
+        /* Skip stale entries: the point was since reached more cheaply */
+        long f = value + getAStarEstimate(routerPtr, x, y, z, dstPtr);
+        if (key != ASTAR_KEY(f, value)) {
+            statsPtr->numCellSkipped++;
+            continue;
+        }
+        if (value > maxValue) {
+            workspacePtr->isOverflow = TRUE;
+            break;
+        }
+        statsPtr->numCellExpanded++;
+
+        expandToNeighborAStar(routerPtr, points, workspacePtr, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_POSX), x+1, y,   z,   (value + xCost), dstPtr);
+        expandToNeighborAStar(routerPtr, points, workspacePtr, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_NEGX), x-1, y,   z,   (value + xCost), dstPtr);
+        expandToNeighborAStar(routerPtr, points, workspacePtr, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_POSY), x,   y+1, z,   (value + yCost), dstPtr);
+        expandToNeighborAStar(routerPtr, points, workspacePtr, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_NEGY), x,   y-1, z,   (value + yCost), dstPtr);
+        expandToNeighborAStar(routerPtr, points, workspacePtr, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_POSZ), x,   y,   z+1, (value + zCost), dstPtr);
+        expandToNeighborAStar(routerPtr, points, workspacePtr, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_NEGZ), x,   y,   z-1, (value + zCost), dstPtr);
+
+    } /* iterate over open set */
+
+    return isPathFound;
+}
+
+
+/* =============================================================================
+ * expandToNeighborDial
+ * -- No window test: fillWindow walls the window in
+ * -- Buckets are keyed by value, i.e. by the label without its move bits
+ * -- Logs newly labelled points at *dirtyPtrPtr, as expandToNeighbor does
+ * =============================================================================
+ */
+static inline void expandToNeighborDial (grid_point_t* points, grid_point_t* neighborGridPointPtr, workspace_t* workspacePtr, long value, long labelShift, uint32_t** dirtyPtrPtr){
+    long neighborValue = *neighborGridPointPtr;
+    long tieMask = (1L << labelShift) - 1;
+    if (neighborValue == GRID_POINT_EMPTY ||
+        (neighborValue != GRID_POINT_FULL && (value | tieMask) < neighborValue))
+    {
+        if (neighborValue != GRID_POINT_EMPTY) {
+            workspacePtr->stats.numCellRelabeled++;
+        } else {
+            *(*dirtyPtrPtr)++ = (uint32_t)(neighborGridPointPtr - points);
+        }
+        (*neighborGridPointPtr) = value;
+        bool_t status = bucketqueue_insert(workspacePtr->bucketQueuePtr, (value >> labelShift),
+                                           (void*)neighborGridPointPtr);
+        assert(status);
+    }
+}
+
+
+/* =============================================================================
+ * dialExpand
+ * -- Pops points in non-decreasing value order, so a point's value is final
+ *    the first time it is popped and every point is expanded at most once.
+ *    Entries left behind by a relabel are discarded when they surface; each
+ *    of those is a re-expansion the FIFO flood would have done.
+ * -- Inlined once per 'labelShift' like leeExpand
+ * =============================================================================
+ */
+static inline __attribute__((always_inline))
+bool_t dialExpand (router_t* routerPtr, grid_t* myGridPtr, workspace_t* workspacePtr, coordinate_t* srcPtr, coordinate_t* dstPtr, long labelShift){
+    bucketqueue_t* bucketQueuePtr = workspacePtr->bucketQueuePtr;
+    router_stats_t* statsPtr = &workspacePtr->stats;
+    grid_point_t* points = myGridPtr->points;
+    long moveMask = (1L << labelShift) - 1;
+    long steps[GRID_NUM_MOVE];
+    getLabelSteps(routerPtr, labelShift, steps);
+    long maxValue = getMaxExpandValue(steps);
+
+    bucketqueue_clear(bucketQueuePtr, GRID_POINT_ORIGIN);
+    grid_point_t* srcGridPointPtr = grid_getPointRef(myGridPtr, srcPtr->x, srcPtr->y, srcPtr->z);
+    bucketqueue_insert(bucketQueuePtr, GRID_POINT_ORIGIN, (void*)srcGridPointPtr);
+    grid_point_t* dstGridPointPtr = grid_getPointRef(myGridPtr, dstPtr->x, dstPtr->y, dstPtr->z);
+    markDirty(workspacePtr, (srcGridPointPtr - points));
+    markDirty(workspacePtr, (dstGridPointPtr - points));
+    *srcGridPointPtr = (GRID_POINT_ORIGIN << labelShift);
+    *dstGridPointPtr = GRID_POINT_EMPTY;
+    bool_t isPathFound = FALSE;
+    uint32_t* dirtyPtr = &workspacePtr->dirtyIndices[workspacePtr->numDirty];
+
+    while (!bucketqueue_isEmpty(bucketQueuePtr)) {
+
+        long key;
+        grid_point_t* gridPointPtr = (grid_point_t*)bucketqueue_remove(bucketQueuePtr, &key);
+        long value = (*gridPointPtr) & ~moveMask;
+        if ((value >> labelShift) != key) {
+            statsPtr->numCellSkipped++;
+            continue;
+        }
+        if (gridPointPtr == dstGridPointPtr) {
+            isPathFound = TRUE;
+            break;
+        }
+
+        if (value > maxValue) {
+            workspacePtr->isOverflow = TRUE;
+            break;
+        }
+
+        long index = gridPointPtr - points;
+        statsPtr->numCellExpanded++;
+
+        expandToNeighborDial(points, &points[grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_POSX)], workspacePtr, (value + steps[GRID_MOVE_POSX]), labelShift, &dirtyPtr);
+        expandToNeighborDial(points, &points[grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_NEGX)], workspacePtr, (value + steps[GRID_MOVE_NEGX]), labelShift, &dirtyPtr);
+        expandToNeighborDial(points, &points[grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_POSY)], workspacePtr, (value + steps[GRID_MOVE_POSY]), labelShift, &dirtyPtr);
+        expandToNeighborDial(points, &points[grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_NEGY)], workspacePtr, (value + steps[GRID_MOVE_NEGY]), labelShift, &dirtyPtr);
+        expandToNeighborDial(points, &points[grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_POSZ)], workspacePtr, (value + steps[GRID_MOVE_POSZ]), labelShift, &dirtyPtr);
+        expandToNeighborDial(points, &points[grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_NEGZ)], workspacePtr, (value + steps[GRID_MOVE_NEGZ]), labelShift, &dirtyPtr);
+
+    } /* iterate over buckets */
+
+    workspacePtr->numDirty = dirtyPtr - workspacePtr->dirtyIndices;
+
+    return isPathFound;
+}
+
+
+/* =============================================================================
+ * doDialExpansion
+ * =============================================================================
+ */
+static bool_t doDialExpansion (router_t* routerPtr, grid_t* myGridPtr, workspace_t* workspacePtr, coordinate_t* srcPtr, coordinate_t* dstPtr){
+    if (routerPtr->isPredecessorLabel) {
+        return dialExpand(routerPtr, myGridPtr, workspacePtr, srcPtr, dstPtr, ROUTER_PRED_SHIFT);
+    }
+    return dialExpand(routerPtr, myGridPtr, workspacePtr, srcPtr, dstPtr, 0);
+}
+
+
+/* =============================================================================
+ * getMeetLength
+ * -- Length through the move from srcIndex, labelled from the source, to
+ *    dstIndex, labelled from the destination, offset by GRID_POINT_ORIGIN
+ * =============================================================================
+ */
+static inline long getMeetLength (grid_point_t* points, long srcIndex, long dstIndex, long cost){
+    return (points[srcIndex] + cost + BIDIR_DST_VALUE(points[dstIndex]));
+}
+
+
+/* =============================================================================
+ * expandToNeighborBidir
+ * -- No window test: fillWindow walls the window in
+ * -- 'value' is the distance from this search's own end point, offset by
+ *    GRID_POINT_ORIGIN on the src side; it is also the bucket key
+ * -- A neighbor the other search labelled is a contact: it is logged in
+ *    meetVectorPtr and may shorten meetLength
+ * =============================================================================
+ */
+static inline void expandToNeighborBidir (grid_point_t* points, long neighborIndex, long value, long cost, bool_t isFromDst, bucketqueue_t* queuePtr, long currIndex, workspace_t* workspacePtr){
+    long neighborValue = points[neighborIndex];
+    if (neighborValue == GRID_POINT_FULL) {
+        return;
+    }
+
+    bool_t isNeighborFromDst = BIDIR_IS_DST_VALUE(neighborValue);
+    if (neighborValue != GRID_POINT_EMPTY && isNeighborFromDst != isFromDst) {
+        long srcIndex = (isFromDst ? neighborIndex : currIndex);
+        long dstIndex = (isFromDst ? currIndex : neighborIndex);
+        indexvector_t* meetVectorPtr = workspacePtr->meetVectorPtr;
+        bool_t status = (indexvector_pushBack(meetVectorPtr, srcIndex) &&
+                         indexvector_pushBack(meetVectorPtr, dstIndex) &&
+                         indexvector_pushBack(meetVectorPtr, cost));
+        assert(status);
+        long length = getMeetLength(points, srcIndex, dstIndex, cost);
+        if (length < workspacePtr->meetLength) {
+            workspacePtr->meetLength = length;
+            workspacePtr->meetSrcIndex = srcIndex;
+            workspacePtr->meetDstIndex = dstIndex;
+        }
+        return;
+    }
+
+    long label = (isFromDst ? BIDIR_DST_VALUE(value) : value);
+    if (neighborValue == GRID_POINT_EMPTY ||
+        (isFromDst ? (label > neighborValue) : (label < neighborValue)))
+    {
+        if (neighborValue != GRID_POINT_EMPTY) {
+            workspacePtr->stats.numCellRelabeled++;
+        } else {
+            markDirty(workspacePtr, neighborIndex);
+        }
+        points[neighborIndex] = label;
+        bool_t status = bucketqueue_insert(queuePtr, value, (void*)(uintptr_t)neighborIndex);
+        assert(status);
+    }
+}
+
+
+/* =============================================================================
+ * doBidirExpansion
+ * -- Bidirectional Dijkstra: grows one search from each end, always the one
+ *    whose smallest key is lower, and stops once the two smallest keys add up
+ *    to the shortest contact seen, when no path through unexpanded points can
+ *    be shorter. The junction is left in meetSrcIndex and meetDstIndex for
+ *    doBidirTraceback.
+ * -- A point belongs to the first search that labels it, so a contact may be
+ *    logged while one side's label can still drop; every contact is measured
+ *    again from the final labels before the junction is chosen. A search that
+ *    runs dry has settled all its points and counts as 0 from then on.
+ * =============================================================================
+ */
+static bool_t doBidirExpansion (router_t* routerPtr, grid_t* myGridPtr, workspace_t* workspacePtr, coordinate_t* srcPtr, coordinate_t* dstPtr){
+    long costs[GRID_NUM_MOVE];
+    getLabelSteps(routerPtr, 0, costs);
+    /* One less: a value d from the destination is labelled GRID_POINT_FULL - 1 - d */
+    long maxValue = getMaxExpandValue(costs) - 1;
+    grid_point_t* points = myGridPtr->points;
+    bucketqueue_t* queuePtrs[2] = { workspacePtr->bucketQueuePtr, workspacePtr->dstBucketQueuePtr };
+    indexvector_t* meetVectorPtr = workspacePtr->meetVectorPtr;
+    router_stats_t* statsPtr = &workspacePtr->stats;
+
+    bucketqueue_clear(queuePtrs[0], GRID_POINT_ORIGIN);
+    bucketqueue_clear(queuePtrs[1], 0);
+    indexvector_clear(meetVectorPtr);
+    long srcIndex = grid_getPointRef(myGridPtr, srcPtr->x, srcPtr->y, srcPtr->z) - points;
+    long dstIndex = grid_getPointRef(myGridPtr, dstPtr->x, dstPtr->y, dstPtr->z) - points;
+    markDirty(workspacePtr, srcIndex);
+    markDirty(workspacePtr, dstIndex);
+    points[srcIndex] = GRID_POINT_ORIGIN;
+    points[dstIndex] = BIDIR_DST_VALUE(0);
+    bucketqueue_insert(queuePtrs[0], GRID_POINT_ORIGIN, (void*)(uintptr_t)srcIndex);
+    bucketqueue_insert(queuePtrs[1], 0, (void*)(uintptr_t)dstIndex);
+    workspacePtr->meetLength = LONG_MAX;
+
+    while (1) {
+        bool_t isSrcDone = bucketqueue_isEmpty(queuePtrs[0]);
+        bool_t isDstDone = bucketqueue_isEmpty(queuePtrs[1]);
+        if ((isSrcDone || isDstDone) && workspacePtr->meetLength == LONG_MAX) {
+            break; /* one end's component never reached the other's */
+        }
+        if (isSrcDone && isDstDone) {
+            break;
+        }
+        long srcKey = (isSrcDone ? GRID_POINT_ORIGIN : bucketqueue_getMinKey(queuePtrs[0]));
+        long dstKey = (isDstDone ? 0 : bucketqueue_getMinKey(queuePtrs[1]));
+        if (srcKey + dstKey >= workspacePtr->meetLength) {
+            break;
+        }
+
+        bool_t isFromDst = (isSrcDone || (!isDstDone && dstKey < (srcKey - GRID_POINT_ORIGIN)));
+        bucketqueue_t* queuePtr = queuePtrs[isFromDst];
+        long key;
+        long index = (long)(uintptr_t)bucketqueue_remove(queuePtr, &key);
+        long value = (isFromDst ? BIDIR_DST_VALUE(points[index]) : points[index]);
+        if (value != key) {
+            statsPtr->numCellSkipped++;
+            continue; /* relabelled lower since it was queued */
+        }
+        if (value > maxValue) {
+            workspacePtr->isOverflow = TRUE;
+            return FALSE;
+        }
+        statsPtr->numCellExpanded++;
+
+        expandToNeighborBidir(points, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_POSX), (value + costs[GRID_MOVE_POSX]), costs[GRID_MOVE_POSX], isFromDst, queuePtr, index, workspacePtr);
+        expandToNeighborBidir(points, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_NEGX), (value + costs[GRID_MOVE_NEGX]), costs[GRID_MOVE_NEGX], isFromDst, queuePtr, index, workspacePtr);
+        expandToNeighborBidir(points, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_POSY), (value + costs[GRID_MOVE_POSY]), costs[GRID_MOVE_POSY], isFromDst, queuePtr, index, workspacePtr);
+        expandToNeighborBidir(points, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_NEGY), (value + costs[GRID_MOVE_NEGY]), costs[GRID_MOVE_NEGY], isFromDst, queuePtr, index, workspacePtr);
+        expandToNeighborBidir(points, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_POSZ), (value + costs[GRID_MOVE_POSZ]), costs[GRID_MOVE_POSZ], isFromDst, queuePtr, index, workspacePtr);
+        expandToNeighborBidir(points, grid_getNeighborIndex(myGridPtr, index, GRID_MOVE_NEGZ), (value + costs[GRID_MOVE_NEGZ]), costs[GRID_MOVE_NEGZ], isFromDst, queuePtr, index, workspacePtr);
+    }
+
+    if (workspacePtr->meetLength == LONG_MAX) {
+        return FALSE;
+    }
+
+    long numMeet = indexvector_getSize(meetVectorPtr);
+    long m;
+    for (m = 0; m < numMeet; m += 3) {
+        long meetSrcIndex = *indexvector_at(meetVectorPtr, m);
+        long meetDstIndex = *indexvector_at(meetVectorPtr, m + 1);
+        long length = getMeetLength(points, meetSrcIndex, meetDstIndex, *indexvector_at(meetVectorPtr, m + 2));
+        if (length < workspacePtr->meetLength) {
+            workspacePtr->meetLength = length;
+            workspacePtr->meetSrcIndex = meetSrcIndex;
+            workspacePtr->meetDstIndex = meetDstIndex;
+        }
+    }
+
+    return TRUE;
+}
 
 
 /* =============================================================================
- * router_alloc
+ * doParallelExpansion
+ * -- The whole team labels myGridPtr; the labels are exact distances, so the
+ *    ordinary traceback applies
  * =============================================================================
  */
-router_t* router_alloc (long xCost, long yCost, long zCost, long bendCost){
-    router_t* routerPtr;
+static bool_t doParallelExpansion (router_t* routerPtr, grid_t* myGridPtr, workspace_t* workspacePtr, coordinate_t* srcPtr, coordinate_t* dstPtr){
+    router_stats_t* statsPtr = &workspacePtr->stats;
+    wavefront_stats_t wavefrontStats;
 
-    routerPtr = (router_t*)malloc(sizeof(router_t));
-    if (routerPtr) {
-        routerPtr->xCost = xCost;
-        routerPtr->yCost = yCost;
-        routerPtr->zCost = zCost;
-        routerPtr->bendCost = bendCost;
-    }
+    memset(&wavefrontStats, 0, sizeof(wavefront_stats_t));
+    bool_t isPathFound = wavefront_expand(workspacePtr->wavefrontPtr, myGridPtr,
+                                          srcPtr, dstPtr, &wavefrontStats);
+    statsPtr->numCellExpanded  += wavefrontStats.numCellExpanded;
+    statsPtr->numCellRelabeled += wavefrontStats.numCellRelabeled;
+    statsPtr->numLevel         += wavefrontStats.numLevel;
+    workspacePtr->isOverflow = ((wavefrontStats.numOverflow > 0) ? TRUE : FALSE);
 
-    return routerPtr;
+    return isPathFound;
 }
 
 
 /* =============================================================================
- * router_free
+ * doBitwaveExpansion
+ * -- Works on bitsets read from the occupancy; myGridPtr is not used
  * =============================================================================
  */
-void router_free (router_t* routerPtr){
-    free(routerPtr);
+static bool_t doBitwaveExpansion (router_t* routerPtr, grid_t* myGridPtr, workspace_t* workspacePtr, coordinate_t* srcPtr, coordinate_t* dstPtr){
+    router_stats_t* statsPtr = &workspacePtr->stats;
+    bitwave_stats_t bitwaveStats;
+
+    memset(&bitwaveStats, 0, sizeof(bitwave_stats_t));
+    bitwaveStats.numByte = statsPtr->numPrivateByte;
+    bool_t isPathFound = bitwave_expand(workspacePtr->bitwavePtr, workspacePtr->occupancyPtr,
+                                        &workspacePtr->window.min,
+                                        &workspacePtr->window.max,
+                                        srcPtr, dstPtr, &bitwaveStats);
+    statsPtr->numCellExpanded += bitwaveStats.numCellExpanded;
+    statsPtr->numLevel        += bitwaveStats.numWave;
+    statsPtr->numPrivateByte   = bitwaveStats.numByte;
+
+    return isPathFound;
 }
 
 
 /* =============================================================================
- * expandToNeighbor
+ * doAkersExpansion
+ * -- Works on its own 2-bit copy of the window; myGridPtr is not used
  * =============================================================================
  */
-static void expandToNeighbor (grid_t* myGridPtr, long x, long y, long z, long value, queue_t* queuePtr){
-    if (grid_isPointValid(myGridPtr, x, y, z)) {
-        long* neighborGridPointPtr = grid_getPointRef(myGridPtr, x, y, z);
-        long neighborValue = *neighborGridPointPtr;
-        if (neighborValue == GRID_POINT_EMPTY) {
-            (*neighborGridPointPtr) = value;
-            queue_push(queuePtr, (void*)neighborGridPointPtr);
-        } else if (neighborValue != GRID_POINT_FULL) {
-            /* We have expanded here before... is this new path better? */
-            if (value < neighborValue) {
-                (*neighborGridPointPtr) = value;
-                queue_push(queuePtr, (void*)neighborGridPointPtr);
-            }
-        }
-    }
+static bool_t doAkersExpansion (router_t* routerPtr, grid_t* myGridPtr, workspace_t* workspacePtr, coordinate_t* srcPtr, coordinate_t* dstPtr){
+    router_stats_t* statsPtr = &workspacePtr->stats;
+    akers_stats_t akersStats;
+
+    akersStats.numCellExpanded = 0;
+    akersStats.numByte = statsPtr->numPrivateByte;
+    bool_t isPathFound = akers_expand(workspacePtr->akersPtr, workspacePtr->occupancyPtr,
+                                      &workspacePtr->window.min,
+                                      &workspacePtr->window.max,
+                                      srcPtr, dstPtr, &akersStats);
+    statsPtr->numCellExpanded += akersStats.numCellExpanded;
+    statsPtr->numPrivateByte   = akersStats.numByte;
+
+    return isPathFound;
 }
 
 
 /* =============================================================================
- * doExpansion
+ * doWideExpansion
+ * -- For an expansion stopped by isOverflow: searches the same window again,
+ *    Dial's way, labelling wideLabels rather than myGridPtr. Its
+ *    GRID_POINT_FULL points, the window's walls included, still block.
+ * -- wideLabels has myGridPtr's shape; 0 is unlabelled, distance d is
+ *    GRID_POINT_ORIGIN + d
  * =============================================================================
  */
-static bool_t doExpansion (router_t* routerPtr, grid_t* myGridPtr, queue_t* queuePtr, coordinate_t* srcPtr, coordinate_t* dstPtr){
-    long xCost = routerPtr->xCost;
-    long yCost = routerPtr->yCost;
-    long zCost = routerPtr->zCost;
+static bool_t doWideExpansion (router_t* routerPtr, grid_t* myGridPtr, workspace_t* workspacePtr, coordinate_t* srcPtr, coordinate_t* dstPtr){
+    bucketqueue_t* bucketQueuePtr = workspacePtr->bucketQueuePtr;
+    router_stats_t* statsPtr = &workspacePtr->stats;
+    grid_point_t* points = myGridPtr->points;
+    long costs[GRID_NUM_MOVE];
+    getLabelSteps(routerPtr, 0, costs);
 
-    /*
-     * Potential Optimization: Make 'src' the one closest to edge.
-     * This will likely decrease the area of the emitted wave.
-     */
+    if (workspacePtr->numWideLabel < myGridPtr->numPoint) {
+        free(workspacePtr->wideLabels);
+        workspacePtr->wideLabels = (long*)malloc(myGridPtr->numPoint * sizeof(long));
+        assert(workspacePtr->wideLabels);
+        workspacePtr->numWideLabel = myGridPtr->numPoint;
+    }
+    long* labels = workspacePtr->wideLabels;
+    memset(labels, 0, myGridPtr->numPoint * sizeof(long));
 
-    queue_clear(queuePtr);
-    long* srcGridPointPtr = grid_getPointRef(myGridPtr, srcPtr->x, srcPtr->y, srcPtr->z);
-    queue_push(queuePtr, (void*)srcGridPointPtr);
-    grid_setPoint(myGridPtr, srcPtr->x, srcPtr->y, srcPtr->z, 0);
-    grid_setPoint(myGridPtr, dstPtr->x, dstPtr->y, dstPtr->z, GRID_POINT_EMPTY);
-    long* dstGridPointPtr = grid_getPointRef(myGridPtr, dstPtr->x, dstPtr->y, dstPtr->z);
-    bool_t isPathFound = FALSE;
+    long srcIndex = grid_getPointRef(myGridPtr, srcPtr->x, srcPtr->y, srcPtr->z) - points;
+    long dstIndex = grid_getPointRef(myGridPtr, dstPtr->x, dstPtr->y, dstPtr->z) - points;
+    bucketqueue_clear(bucketQueuePtr, GRID_POINT_ORIGIN);
+    bucketqueue_insert(bucketQueuePtr, GRID_POINT_ORIGIN, (void*)(uintptr_t)srcIndex);
+    labels[srcIndex] = GRID_POINT_ORIGIN;
 
-    while (!queue_isEmpty(queuePtr)) {
+    while (!bucketqueue_isEmpty(bucketQueuePtr)) {
 
-        long* gridPointPtr = (long*)queue_pop(queuePtr);
-        if (gridPointPtr == dstGridPointPtr) {
-            isPathFound = TRUE;
-            break;
+        long key;
+        long index = (long)(uintptr_t)bucketqueue_remove(bucketQueuePtr, &key);
+        long value = labels[index];
+        if (value != key) {
+            statsPtr->numCellSkipped++;
+            continue;
         }
+        if (index == dstIndex) {
+            return TRUE;
+        }
+        statsPtr->numCellExpanded++;
 
-        long x;
-        long y;
-        long z;
-        grid_getPointIndices(myGridPtr, gridPointPtr, &x, &y, &z);
-        long value = (*gridPointPtr);
-
-        /*
-         * Check 6 neighbors
-         *
-         * Potential Optimization: Only need to check 5 of these
-         */
-        expandToNeighbor(myGridPtr, x+1, y,   z,   (value + xCost), queuePtr);
-        expandToNeighbor(myGridPtr, x-1, y,   z,   (value + xCost), queuePtr);
-        expandToNeighbor(myGridPtr, x,   y+1, z,   (value + yCost), queuePtr);
-        expandToNeighbor(myGridPtr, x,   y-1, z,   (value + yCost), queuePtr);
-        expandToNeighbor(myGridPtr, x,   y,   z+1, (value + zCost), queuePtr);
-        expandToNeighbor(myGridPtr, x,   y,   z-1, (value + zCost), queuePtr);
+        long m;
+        for (m = 0; m < GRID_NUM_MOVE; m++) {
+            long neighborIndex = grid_getNeighborIndex(myGridPtr, index, (grid_move_t)m);
+            long neighborValue = labels[neighborIndex];
+            long newValue = value + costs[m];
+            if (points[neighborIndex] == GRID_POINT_FULL ||
+                (neighborValue != 0 && neighborValue <= newValue))
+            {
+                continue;
+            }
+            if (neighborValue != 0) {
+                statsPtr->numCellRelabeled++;
+            }
+            labels[neighborIndex] = newValue;
+            bool_t status = bucketqueue_insert(bucketQueuePtr, newValue, (void*)(uintptr_t)neighborIndex);
+            assert(status);
+        }
 
-    } /* iterate over work queue */
+    } /* iterate over buckets */
 
-    return isPathFound;
+    return FALSE;
 }
 
 
 /* =============================================================================
- * traceToNeighbor
+ * doExpansion
  * =============================================================================
  */
-static void traceToNeighbor (grid_t* myGridPtr, point_t* currPtr, point_t* movePtr, bool_t useMomentum, long bendCost, point_t* nextPtr){
-    long x = currPtr->x + movePtr->x;
-    long y = currPtr->y + movePtr->y;
-    long z = currPtr->z + movePtr->z;
+static bool_t doExpansion (router_t* routerPtr, grid_t* myGridPtr, workspace_t* workspacePtr, coordinate_t* srcPtr, coordinate_t* dstPtr){
+    workspacePtr->stats.numExpansion++;
 
-    if (grid_isPointValid(myGridPtr, x, y, z) &&
-        !grid_isPointEmpty(myGridPtr, x, y, z) &&
-        !grid_isPointFull(myGridPtr, x, y, z))
-    {
-        long value = grid_getPoint(myGridPtr, x, y, z);
-        long b = 0;
-        if (useMomentum && (currPtr->momentum != movePtr->momentum)) {
-            b = bendCost;
-        }
-        if ((value + b) <= nextPtr->value) { /* '=' favors neighbors over current */
-            nextPtr->x = x;
-            nextPtr->y = y;
-            nextPtr->z = z;
-            nextPtr->value = value;
-            nextPtr->momentum = movePtr->momentum;
-        }
+    switch (routerPtr->expansion) {
+        case ROUTER_EXPANSION_ASTAR:
+            return doAStarExpansion(routerPtr, myGridPtr, workspacePtr, srcPtr, dstPtr);
+        case ROUTER_EXPANSION_BIDIR:
+            return doBidirExpansion(routerPtr, myGridPtr, workspacePtr, srcPtr, dstPtr);
+        case ROUTER_EXPANSION_DIAL:
+            return doDialExpansion(routerPtr, myGridPtr, workspacePtr, srcPtr, dstPtr);
+        case ROUTER_EXPANSION_PARALLEL:
+            return doParallelExpansion(routerPtr, myGridPtr, workspacePtr, srcPtr, dstPtr);
+        case ROUTER_EXPANSION_BITWAVE:
+            return doBitwaveExpansion(routerPtr, myGridPtr, workspacePtr, srcPtr, dstPtr);
+        case ROUTER_EXPANSION_AKERS:
+            return doAkersExpansion(routerPtr, myGridPtr, workspacePtr, srcPtr, dstPtr);
+        case ROUTER_EXPANSION_LEE:
+        default:
+            return doLeeExpansion(routerPtr, myGridPtr, workspacePtr, srcPtr, dstPtr);
     }
 }
 
 
 /* =============================================================================
- * doTraceback
+ * getTraceValue
+ * -- Distance to the end point this trace is heading for, or -1 if the point
+ *    was not labelled by that end's wavefront
+ * =============================================================================
+ */
+static inline long getTraceValue (long value, bool_t isToDst){
+    if (isToDst) {
+        return (BIDIR_IS_DST_VALUE(value) ? BIDIR_DST_VALUE(value) : -1);
+    }
+
+    /* GRID_POINT_EMPTY, GRID_POINT_FULL and dst labels are < GRID_POINT_ORIGIN */
+    return ((value >= GRID_POINT_ORIGIN) ? (value - GRID_POINT_ORIGIN) : -1);
+}
+
+
+/* =============================================================================
+ * traceToNeighbor
  * =============================================================================
  */
-static vector_t* doTraceback (grid_t* gridPtr, grid_t* myGridPtr, coordinate_t* dstPtr, long bendCost){
-    vector_t* pointVectorPtr = vector_alloc(1);
-    assert(pointVectorPtr);
+static void traceToNeighbor (grid_t* myGridPtr, point_t* currPtr, grid_move_t move, bool_t useMomentum, long bendCost, bool_t isToDst, point_t* nextPtr){
+    /* The border is full, so the neighbor needs no bounds test */
+    long index = grid_getNeighborIndex(myGridPtr, currPtr->index, move);
+    long value = getTraceValue(myGridPtr->points[index], isToDst);
+    if (value < 0) {
+        return;
+    }
+    momentum_t momentum = (momentum_t)(MOMENTUM_POSX + move);
+    long b = 0;
+    if (useMomentum && (currPtr->momentum != momentum)) {
+        b = bendCost;
+    }
+    if ((value + b) <= nextPtr->value) { /* '=' favors neighbors over current */
+        nextPtr->index = index;
+        nextPtr->value = value;
+        nextPtr->momentum = momentum;
+    }
+}
+
 
+/* =============================================================================
+ * traceToEnd
+ * -- Walks down the distance field from 'startIndex' to the point labelled 0,
+ *    appending the index of every point to pointVectorPtr
+ * -- Returns FALSE if the walk gets stuck
+ * =============================================================================
+ */
+static bool_t traceToEnd (grid_t* myGridPtr, long startIndex, long bendCost, bool_t isToDst, indexvector_t* pointVectorPtr){
     point_t next;
-    next.x = dstPtr->x;
-    next.y = dstPtr->y;
-    next.z = dstPtr->z;
-    next.value = grid_getPoint(myGridPtr, next.x, next.y, next.z);
+    next.index = startIndex;
+    next.value = getTraceValue(myGridPtr->points[next.index], isToDst);
     next.momentum = MOMENTUM_ZERO;
 
+    /* Each step lowers the value by a move's cost, so value + 1 points is enough */
+    bool_t status = indexvector_reserve(pointVectorPtr, indexvector_getSize(pointVectorPtr) + next.value + 1);
+    assert(status);
+
     while (1) {
 
-        long* gridPointPtr = grid_getPointRef(gridPtr, next.x, next.y, next.z);
-        vector_pushBack(pointVectorPtr, (void*)gridPointPtr);
-        grid_setPoint(myGridPtr, next.x, next.y, next.z, GRID_POINT_FULL);
+        /* The shared grid and myGridPtr have the same shape, so indices carry over */
+        indexvector_pushBack(pointVectorPtr, next.index);
+        myGridPtr->points[next.index] = GRID_POINT_FULL;
 
         /* Check if we are done */
         if (next.value == 0) {
@@ -252,40 +1598,465 @@ static vector_t* doTraceback (grid_t* gridPtr, grid_t* myGridPtr, coordinate_t*
          *
          * Potential Optimization: Only need to check 5 of these
          */
-        traceToNeighbor(myGridPtr, &curr, &MOVE_POSX, TRUE, bendCost, &next);
-        traceToNeighbor(myGridPtr, &curr, &MOVE_POSY, TRUE, bendCost, &next);
-        traceToNeighbor(myGridPtr, &curr, &MOVE_POSZ, TRUE, bendCost, &next);
-        traceToNeighbor(myGridPtr, &curr, &MOVE_NEGX, TRUE, bendCost, &next);
-        traceToNeighbor(myGridPtr, &curr, &MOVE_NEGY, TRUE, bendCost, &next);
-        traceToNeighbor(myGridPtr, &curr, &MOVE_NEGZ, TRUE, bendCost, &next);
+        traceToNeighbor(myGridPtr, &curr, GRID_MOVE_POSX, TRUE, bendCost, isToDst, &next);
+        traceToNeighbor(myGridPtr, &curr, GRID_MOVE_POSY, TRUE, bendCost, isToDst, &next);
+        traceToNeighbor(myGridPtr, &curr, GRID_MOVE_POSZ, TRUE, bendCost, isToDst, &next);
+        traceToNeighbor(myGridPtr, &curr, GRID_MOVE_NEGX, TRUE, bendCost, isToDst, &next);
+        traceToNeighbor(myGridPtr, &curr, GRID_MOVE_NEGY, TRUE, bendCost, isToDst, &next);
+        traceToNeighbor(myGridPtr, &curr, GRID_MOVE_NEGZ, TRUE, bendCost, isToDst, &next);
 
         /*
          * Because of bend costs, none of the neighbors may appear to be closer.
          * In this case, pick a neighbor while ignoring momentum.
          */
-        if ((curr.x == next.x) &&
-            (curr.y == next.y) &&
-            (curr.z == next.z))
-        {
+        if (curr.index == next.index) {
             next.value = curr.value;
-            traceToNeighbor(myGridPtr, &curr, &MOVE_POSX, FALSE, bendCost, &next);
-            traceToNeighbor(myGridPtr, &curr, &MOVE_POSY, FALSE, bendCost, &next);
-            traceToNeighbor(myGridPtr, &curr, &MOVE_POSZ, FALSE, bendCost, &next);
-            traceToNeighbor(myGridPtr, &curr, &MOVE_NEGX, FALSE, bendCost, &next);
-            traceToNeighbor(myGridPtr, &curr, &MOVE_NEGY, FALSE, bendCost, &next);
-            traceToNeighbor(myGridPtr, &curr, &MOVE_NEGZ, FALSE, bendCost, &next);
-
-            if ((curr.x == next.x) &&
-                (curr.y == next.y) &&
-                (curr.z == next.z))
+            traceToNeighbor(myGridPtr, &curr, GRID_MOVE_POSX, FALSE, bendCost, isToDst, &next);
+            traceToNeighbor(myGridPtr, &curr, GRID_MOVE_POSY, FALSE, bendCost, isToDst, &next);
+            traceToNeighbor(myGridPtr, &curr, GRID_MOVE_POSZ, FALSE, bendCost, isToDst, &next);
+            traceToNeighbor(myGridPtr, &curr, GRID_MOVE_NEGX, FALSE, bendCost, isToDst, &next);
+            traceToNeighbor(myGridPtr, &curr, GRID_MOVE_NEGY, FALSE, bendCost, isToDst, &next);
+            traceToNeighbor(myGridPtr, &curr, GRID_MOVE_NEGZ, FALSE, bendCost, isToDst, &next);
+
+            if (curr.index == next.index) {
+                return FALSE; /* cannot find path */
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+
+/* =============================================================================
+ * doTraceback
+ * =============================================================================
+ */
+static bool_t doTraceback (grid_t* myGridPtr, coordinate_t* dstPtr, long bendCost, indexvector_t* pointVectorPtr){
+    long dstIndex = grid_getPointRef(myGridPtr, dstPtr->x, dstPtr->y, dstPtr->z) - myGridPtr->points;
+    return traceToEnd(myGridPtr, dstIndex, bendCost, FALSE, pointVectorPtr);
+}
+
+
+/* =============================================================================
+ * doPredecessorTraceback
+ * -- Follows the moves recorded in predecessor labels from 'dstPtr' back to
+ *    'srcPtr'. Where the point straight ahead is an equally short way back
+ *    it is taken instead, so ties still go to the path with fewer bends.
+ * -- Stops at the source itself rather than at value 0, so zero-cost moves
+ *    need no special care
+ * =============================================================================
+ */
+static bool_t doPredecessorTraceback (router_t* routerPtr, grid_t* myGridPtr, coordinate_t* srcPtr, coordinate_t* dstPtr, indexvector_t* pointVectorPtr){
+    grid_point_t* points = myGridPtr->points;
+    long steps[GRID_NUM_MOVE];
+    getLabelSteps(routerPtr, ROUTER_PRED_SHIFT, steps);
+
+    long srcIndex = grid_getPointRef(myGridPtr, srcPtr->x, srcPtr->y, srcPtr->z) - points;
+    long index = grid_getPointRef(myGridPtr, dstPtr->x, dstPtr->y, dstPtr->z) - points;
+    long label = points[index];
+    grid_move_t momentum = GRID_NUM_MOVE; /* none yet */
+
+    /* Zero-cost moves aside, the path has at most value + 1 points */
+    bool_t status = indexvector_reserve(pointVectorPtr, (PRED_LABEL_VALUE(label) - GRID_POINT_ORIGIN + 1));
+    assert(status);
+
+    while (1) {
+
+        /* The shared grid and myGridPtr have the same shape, so indices carry over */
+        indexvector_pushBack(pointVectorPtr, index);
+        points[index] = GRID_POINT_FULL;
+
+        if (index == srcIndex) {
+            break;
+        }
+        long value = PRED_LABEL_VALUE(label);
+
+        grid_move_t move = PRED_OPPOSITE_MOVE(PRED_LABEL_MOVE(label));
+        if (momentum != GRID_NUM_MOVE && move != momentum &&
+            (steps[momentum] >> ROUTER_PRED_SHIFT) > 0)
+        {
+            long aheadLabel = points[grid_getNeighborIndex(myGridPtr, index, momentum)];
+            if (aheadLabel >= (GRID_POINT_ORIGIN << ROUTER_PRED_SHIFT) &&
+                (PRED_LABEL_VALUE(aheadLabel) + (steps[momentum] >> ROUTER_PRED_SHIFT)) == value)
+            {
+                move = momentum;
+            }
+        }
+
+        index = grid_getNeighborIndex(myGridPtr, index, move);
+        label = points[index];
+        if (label < (GRID_POINT_ORIGIN << ROUTER_PRED_SHIFT)) {
+            return FALSE; /* cannot find path */
+        }
+        momentum = move;
+    }
+
+    return TRUE;
+}
+
+
+/* =============================================================================
+ * doBidirTraceback
+ * -- Stitches dst..meetDstIndex (traced, then reversed) to meetSrcIndex..src,
+ *    giving the same dst-to-src order as doTraceback
+ * =============================================================================
+ */
+static bool_t doBidirTraceback (grid_t* myGridPtr, workspace_t* workspacePtr, long bendCost, indexvector_t* pointVectorPtr){
+    if (!traceToEnd(myGridPtr, workspacePtr->meetDstIndex, bendCost, TRUE, pointVectorPtr)) {
+        return FALSE;
+    }
+
+    long* elements = indexvector_at(pointVectorPtr, 0);
+    long i;
+    long j;
+    for (i = 0, j = indexvector_getSize(pointVectorPtr) - 1; i < j; i++, j--) {
+        long tmp = elements[i];
+        elements[i] = elements[j];
+        elements[j] = tmp;
+    }
+
+    return traceToEnd(myGridPtr, workspacePtr->meetSrcIndex, bendCost, FALSE, pointVectorPtr);
+}
+
+
+/*
+ * A path waiting for the thread that combines commits
+ */
+typedef struct commit_request {
+    occupancy_t* occupancyPtr;
+    grid_t* gridPtr;
+    path_t* pathPtr;
+    indexvector_t* regionVectorPtr;
+    unsigned long* versions;
+    bool_t isUnvalidated;  /* written by the combining thread */
+} commit_request_t;
+
+
+/* =============================================================================
+ * doWideTraceback
+ * -- Walks down the wideLabels of doWideExpansion from 'dstPtr' to 'srcPtr',
+ *    keeping to the last move where it can. A point is unlabelled once left,
+ *    so zero-cost moves cannot loop. myGridPtr is not written.
+ * =============================================================================
+ */
+static bool_t doWideTraceback (router_t* routerPtr, grid_t* myGridPtr, workspace_t* workspacePtr, coordinate_t* srcPtr, coordinate_t* dstPtr, indexvector_t* pointVectorPtr){
+    long* labels = workspacePtr->wideLabels;
+    long costs[GRID_NUM_MOVE];
+    getLabelSteps(routerPtr, 0, costs);
+
+    long srcIndex = grid_getPointRef(myGridPtr, srcPtr->x, srcPtr->y, srcPtr->z) - myGridPtr->points;
+    long index = grid_getPointRef(myGridPtr, dstPtr->x, dstPtr->y, dstPtr->z) - myGridPtr->points;
+    grid_move_t lastMove = GRID_NUM_MOVE;
+
+    while (1) {
+        bool_t status = indexvector_pushBack(pointVectorPtr, index);
+        assert(status);
+        if (index == srcIndex) {
+            break;
+        }
+        long value = labels[index];
+        labels[index] = 0;
+
+        grid_move_t nextMove = GRID_NUM_MOVE;
+        long m;
+        for (m = 0; m < GRID_NUM_MOVE; m++) {
+            long neighborValue = labels[grid_getNeighborIndex(myGridPtr, index, (grid_move_t)m)];
+            if (neighborValue != 0 && neighborValue + costs[m] == value &&
+                (nextMove == GRID_NUM_MOVE || m == lastMove))
+            {
+                nextMove = (grid_move_t)m;
+            }
+        }
+        if (nextMove == GRID_NUM_MOVE) {
+            return FALSE; /* cannot find path */
+        }
+        index = grid_getNeighborIndex(myGridPtr, index, nextMove);
+        lastMove = nextMove;
+    }
+
+    return TRUE;
+}
+
+
+/* =============================================================================
+ * addCheckedPath
+ * -- Marks the path unless one of its points is taken; the caller holds
+ *    whatever serializes commits
+ * -- Skips the point-by-point check if no region the path crosses changed
+ *    since 'versions' and says so in *isUnvalidatedPtr
+ * =============================================================================
+ */
+static bool_t addCheckedPath (occupancy_t* occupancyPtr, grid_t* gridPtr, path_t* pathPtr, indexvector_t* regionVectorPtr, unsigned long* versions, bool_t* isUnvalidatedPtr){
+    bool_t isCommitted;
+    *isUnvalidatedPtr = occupancy_areRegionsUnchanged(occupancyPtr, regionVectorPtr, versions);
+    if (*isUnvalidatedPtr) {
+        /* Nothing committed near it since the snapshot the path was found in */
+        isCommitted = TRUE;
+    } else {
+        //verificar se o caminho esta livre
+        isCommitted = occupancy_isPathFree(occupancyPtr, gridPtr, pathPtr);
+    }
+    if (isCommitted) {
+        occupancy_addPath(occupancyPtr, gridPtr, pathPtr);
+    }
+
+    return isCommitted;
+}
+
+
+/* =============================================================================
+ * applyRequest
+ * -- combiner_run callback
+ * =============================================================================
+ */
+static bool_t applyRequest (void* requestPtr){
+    commit_request_t* rPtr = (commit_request_t*)requestPtr;
+    return addCheckedPath(rPtr->occupancyPtr, rPtr->gridPtr, rPtr->pathPtr,
+                          rPtr->regionVectorPtr, rPtr->versions, &rPtr->isUnvalidated);
+}
+
+
+/* =============================================================================
+ * getLatencyBucket
+ * -- Smallest b with seconds under 2^b microseconds, capped at the last bucket
+ * =============================================================================
+ */
+static long getLatencyBucket (double seconds){
+    double bound = 1e-6;
+    long b;
+    for (b = 0; b < ROUTER_NUM_LATENCY_BUCKET - 1; b++) {
+        if (seconds < bound) {
+            break;
+        }
+        bound *= 2.0;
+    }
+    return b;
+}
+
+
+/* =============================================================================
+ * commitPath
+ * -- Marks the path in the shared occupancy unless another thread took one of
+ *    its points since the private grid was filled
+ * -- If a region the path crosses changed since snapshotVersions, a path
+ *    already blocked is given up before locking or claiming anything; if none
+ *    did, the lock and combine modes commit without checking the path point
+ *    by point
+ * =============================================================================
+ */
+static bool_t commitPath (router_t* routerPtr, occupancy_t* occupancyPtr, grid_t* gridPtr, path_t* pathPtr, pthread_mutex_t* lockPtr, combiner_t* combinerPtr, long myId, workspace_t* workspacePtr){
+    router_stats_t* statsPtr = &workspacePtr->stats;
+    indexvector_t* regionVectorPtr = workspacePtr->regionVectorPtr;
+    unsigned long* versions = workspacePtr->snapshotVersions;
+    TIMER_T commitStart;
+    TIMER_T commitStop;
+    TIMER_READ(commitStart);
+    occupancy_getPathRegions(occupancyPtr, gridPtr, pathPtr, regionVectorPtr);
+    bool_t isCommitted;
+    bool_t isUnvalidated = FALSE;
+    if (!occupancy_areRegionsUnchanged(occupancyPtr, regionVectorPtr, versions) &&
+        !occupancy_isPathFree(occupancyPtr, gridPtr, pathPtr))
+    {
+        statsPtr->numEarlyRestart++;
+        isCommitted = FALSE;
+    } else if (routerPtr->commit == ROUTER_COMMIT_CAS) {
+        isCommitted = occupancy_claimPath(occupancyPtr, gridPtr, pathPtr);
+    } else if (routerPtr->commit == ROUTER_COMMIT_STM) {
+        isCommitted = occupancy_transactPath(occupancyPtr, gridPtr, pathPtr, &statsPtr->numAttempt);
+    } else if (routerPtr->commit == ROUTER_COMMIT_COMBINE) {
+        commit_request_t request = {occupancyPtr, gridPtr, pathPtr, regionVectorPtr, versions, FALSE};
+        isCommitted = combiner_run(combinerPtr, myId, &request, &applyRequest);
+        isUnvalidated = request.isUnvalidated;
+    } else {
+        pthread_mutex_lock(lockPtr);
+        isCommitted = addCheckedPath(occupancyPtr, gridPtr, pathPtr,
+                                     regionVectorPtr, versions, &isUnvalidated);
+        pthread_mutex_unlock(lockPtr);
+    }
+    TIMER_READ(commitStop);
+    double seconds = TIMER_DIFF_SECONDS(commitStart, commitStop);
+    statsPtr->commitSeconds += seconds;
+    statsPtr->numCommitLatency[getLatencyBucket(seconds)]++;
+    if (isUnvalidated) {
+        statsPtr->numUnvalidated++;
+    }
+    if (isCommitted) {
+        statsPtr->numCommitted++;
+    } else {
+        statsPtr->numConflict++;
+    }
+
+    return isCommitted;
+}
+
+
+/* =============================================================================
+ * isWindowApart
+ * -- TRUE if the x-y footprints of the two windows do not meet
+ * =============================================================================
+ */
+static bool_t isWindowApart (window_t* aPtr, window_t* bPtr){
+    return ((aPtr->max.x < bPtr->min.x || bPtr->max.x < aPtr->min.x ||
+             aPtr->max.y < bPtr->min.y || bPtr->max.y < aPtr->min.y) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * packLane
+ * -- Adds the net to the batch if its window is apart from those of the nets
+ *    already in it; returns FALSE otherwise
+ * =============================================================================
+ */
+static bool_t packLane (grid_t* gridPtr, batch_net_t* lanes, window_t* laneWindows, long* numLanePtr, batch_net_t* netPtr){
+    window_t window;
+    long l;
+
+    setWindow(&window, gridPtr, netPtr->srcPtr, netPtr->dstPtr, netPtr->margin);
+    for (l = 0; l < *numLanePtr; l++) {
+        if (!isWindowApart(&window, &laneWindows[l])) {
+            return FALSE;
+        }
+    }
+    lanes[*numLanePtr] = *netPtr;
+    laneWindows[*numLanePtr] = window;
+    (*numLanePtr)++;
+
+    return TRUE;
+}
+
+
+/* =============================================================================
+ * routeBatches
+ * -- Routes the work queue up to MULTIWAVE_NUM_LANE nets per expansion
+ * -- Each net floods only its window, and a batch only takes nets whose
+ *    windows are apart, so the paths of a batch cannot cross; the other nets
+ *    are held over, in order, for the next one
+ * -- A net blocked inside its window widens it as router_solve does, and it
+ *    and any net that loses a point to another thread lead the next batch
+ * =============================================================================
+ */
+static void routeBatches (router_t* routerPtr, maze_t* mazePtr, workpool_t* workpoolPtr, long myId, workspace_t* workspacePtr, vector_t* myPathVectorPtr, pthread_mutex_t* lockPtr, combiner_t* combinerPtr){
+    grid_t* gridPtr = mazePtr->gridPtr;
+    occupancy_t* occupancyPtr = mazePtr->occupancyPtr;
+    router_stats_t* statsPtr = &workspacePtr->stats;
+    long startMargin = ((routerPtr->windowMargin >= 0) ? routerPtr->windowMargin : ROUTER_BATCH_MARGIN);
+    batch_net_t lanes[MULTIWAVE_NUM_LANE];
+    window_t laneWindows[MULTIWAVE_NUM_LANE];
+    coordinate_t* srcPtrs[MULTIWAVE_NUM_LANE];
+    coordinate_t* dstPtrs[MULTIWAVE_NUM_LANE];
+    coordinate_t* minPtrs[MULTIWAVE_NUM_LANE];
+    coordinate_t* maxPtrs[MULTIWAVE_NUM_LANE];
+    batch_net_t held[2 * MULTIWAVE_NUM_LANE];
+    long numHeld = 0;
+
+    while (1) {
+
+        long numLane = 0;
+        long numStillHeld = 0;
+        long h;
+        long l;
+
+        for (h = 0; h < numHeld; h++) {
+            if (numLane == MULTIWAVE_NUM_LANE ||
+                !packLane(gridPtr, lanes, laneWindows, &numLane, &held[h]))
             {
-                vector_free(pointVectorPtr);
-                return NULL; /* cannot find path */
+                held[numStillHeld++] = held[h];
+            }
+        }
+        numHeld = numStillHeld;
+        while (numLane < MULTIWAVE_NUM_LANE && numHeld < MULTIWAVE_NUM_LANE) {
+            long priority;
+            pair_t* coordinatePairPtr = (pair_t*)workpool_pop(workpoolPtr, myId, &priority);
+            if (coordinatePairPtr == NULL) {
+                break;
+            }
+            batch_net_t net = { coordinatePairPtr->firstPtr, coordinatePairPtr->secondPtr, startMargin, 0 };
+            pair_free(coordinatePairPtr);
+            if (!packLane(gridPtr, lanes, laneWindows, &numLane, &net)) {
+                held[numHeld++] = net;
+            }
+        }
+        if (numLane == 0) {
+            break; /* an empty batch takes the first held net, so none are left */
+        }
+
+        for (l = 0; l < numLane; l++) {
+            srcPtrs[l] = lanes[l].srcPtr;
+            dstPtrs[l] = lanes[l].dstPtr;
+            minPtrs[l] = &laneWindows[l].min;
+            maxPtrs[l] = &laneWindows[l].max;
+        }
+        occupancy_readVersions(occupancyPtr, workspacePtr->snapshotVersions);
+        multiwave_stats_t multiwaveStats;
+        memset(&multiwaveStats, 0, sizeof(multiwave_stats_t));
+        TIMER_T expansionStart;
+        TIMER_T expansionStop;
+        TIMER_READ(expansionStart);
+        uint64_t foundMask = multiwave_expand(workspacePtr->multiwavePtr, occupancyPtr,
+                                              numLane, srcPtrs, dstPtrs, minPtrs, maxPtrs,
+                                              &multiwaveStats);
+        TIMER_READ(expansionStop);
+        statsPtr->expansionSeconds += TIMER_DIFF_SECONDS(expansionStart, expansionStop);
+        statsPtr->numExpansion    += numLane;
+        statsPtr->numBatch++;
+        statsPtr->numCellExpanded += multiwaveStats.numCellExpanded;
+        statsPtr->numLevel        += multiwaveStats.numWave;
+        statsPtr->numPrivateByte   = multiwaveStats.numByte;
+
+        long numRetry = 0;
+        for (l = 0; l < numLane; l++) {
+            batch_net_t* netPtr = &lanes[l];
+            if (!((foundMask >> l) & 1)) {
+                if (!isWindowWholeGrid(&laneWindows[l], gridPtr)) {
+                    /* Blocked inside the window: double the margin and retry */
+                    netPtr->margin = MAX(2 * netPtr->margin, 1L);
+                    netPtr->numWiden++;
+                    lanes[numRetry++] = *netPtr;
+                }
+                continue; /* else unroutable */
             }
+            TIMER_T tracebackStart;
+            TIMER_T tracebackStop;
+            TIMER_READ(tracebackStart);
+            indexvector_t* pointVectorPtr = workspacePtr->traceVectorPtr;
+            indexvector_clear(pointVectorPtr);
+            bool_t isTraced = multiwave_traceback(workspacePtr->multiwavePtr,
+                                                  gridPtr, l, pointVectorPtr);
+            TIMER_READ(tracebackStop);
+            statsPtr->tracebackSeconds += TIMER_DIFF_SECONDS(tracebackStart, tracebackStop);
+            if (!isTraced) {
+                continue;
+            }
+            path_t* pathPtr = path_alloc(gridPtr, pointVectorPtr);
+            assert(pathPtr);
+            if (!commitPath(routerPtr, occupancyPtr, gridPtr, pathPtr, lockPtr, combinerPtr, myId, workspacePtr)) {
+                path_free(pathPtr);
+                lanes[numRetry++] = *netPtr;
+                continue;
+            }
+            statsPtr->numWindowStep[MIN(netPtr->numWiden, ROUTER_MAX_WINDOW_STEP - 1)]++;
+            bool_t status = vector_pushBack(myPathVectorPtr, (void*)pathPtr);
+            assert(status);
+        }
+        if (numRetry > 0) {
+            memmove(&held[numRetry], &held[0], numHeld * sizeof(batch_net_t));
+            memcpy(&held[0], &lanes[0], numRetry * sizeof(batch_net_t));
+            numHeld += numRetry;
         }
     }
+}
 
-    return pointVectorPtr;
+
+/* =============================================================================
+ * getQueueEstimate
+ * -- A flood's FIFO holds its wavefront, which spreads as a ring over the
+ *    x-y plane through every layer; the grid's x-y perimeter times its depth
+ *    covers it (peaks run at about half that), so pushes rarely grow the ring
+ * =============================================================================
+ */
+static long getQueueEstimate (grid_t* gridPtr){
+    return (2 * (gridPtr->width + gridPtr->height) * gridPtr->depth);
 }
 
 
@@ -298,17 +2069,111 @@ void router_solve (void* argPtr){
     router_solve_arg_t* routerArgPtr = (router_solve_arg_t*)argPtr;
     router_t* routerPtr = routerArgPtr->routerPtr;
     maze_t* mazePtr = routerArgPtr->mazePtr;
-    vector_t* myPathVectorPtr = vector_alloc(1);
+    /* Any one thread may end up routing every path */
+    vector_t* myPathVectorPtr = vector_alloc(coordinatevector_getSize(mazePtr->srcVectorPtr));
     assert(myPathVectorPtr);
 
     pthread_mutex_t* lockPtr = routerArgPtr->lockPtr;
+    combiner_t* combinerPtr = routerArgPtr->combinerPtr;
 
-    queue_t* workQueuePtr = mazePtr->workQueuePtr;
+    workpool_t* workpoolPtr = routerArgPtr->workpoolPtr;
+    long myId = workpool_join(workpoolPtr);
     grid_t* gridPtr = mazePtr->gridPtr;
-    grid_t* myGridPtr = grid_alloc(gridPtr->width, gridPtr->height, gridPtr->depth);
-    assert(myGridPtr);
+    occupancy_t* occupancyPtr = mazePtr->occupancyPtr;
     long bendCost = routerPtr->bendCost;
-    queue_t* myExpansionQueuePtr = queue_alloc(-1);
+    workspace_t myWorkspace;
+    memset(&myWorkspace, 0, sizeof(workspace_t));
+
+    /*
+     * The private grid covers the whole grid unless that would break the
+     * memory ceiling; then it is reshaped to each search window in turn,
+     * inside a buffer of the largest size the ceiling allows
+     */
+    grid_t* myGridPtr = NULL;
+    bool_t isLogged = isDirtyLogged(routerPtr->expansion);
+    long numBytePerPoint = (sizeof(grid_point_t) + (isLogged ? sizeof(uint32_t) : 0));
+    long maxPoint = gridPtr->numPoint;
+    bool_t isWindowGrid = ((routerPtr->maxPrivateByte > 0 &&
+                            router_isWindowGridSupported(routerPtr->expansion) &&
+                            (maxPoint + 1) * numBytePerPoint > routerPtr->maxPrivateByte) ? TRUE : FALSE);
+    if (isWindowGrid) {
+        maxPoint = (routerPtr->maxPrivateByte / numBytePerPoint) - 1;
+        myGridPtr = grid_allocBuffer(maxPoint);
+        assert(myGridPtr);
+    } else if (routerPtr->expansion != ROUTER_EXPANSION_AKERS &&
+               routerPtr->expansion != ROUTER_EXPANSION_BITWAVE &&
+               routerPtr->expansion != ROUTER_EXPANSION_BATCH)
+    {
+        myGridPtr = grid_alloc(gridPtr->width, gridPtr->height, gridPtr->depth);
+        assert(myGridPtr);
+        myWorkspace.stats.numPrivateByte = (maxPoint + 1) * numBytePerPoint;
+    }
+    if (isLogged) {
+        myWorkspace.dirtyIndices = (uint32_t*)malloc((maxPoint + 1) * sizeof(uint32_t));
+        assert(myWorkspace.dirtyIndices);
+    }
+    bool_t isDirtyReset = ((isLogged && !isWindowGrid) ? TRUE : FALSE);
+    /* Repairs build on the last attempt's labels, which only a dirty reset keeps */
+    bool_t isRepairing = ((routerPtr->isRepairing && isDirtyReset) ? TRUE : FALSE);
+    if (isDirtyReset) {
+        /* Copy the occupancy once; resetWindow keeps it current from here */
+        coordinate_t gridMin = { 0, 0, 0 };
+        coordinate_t gridMax = { gridPtr->width - 1, gridPtr->height - 1, gridPtr->depth - 1 };
+        myWorkspace.numCommitSeen = occupancy_getNumCommit(occupancyPtr);
+        myWorkspace.numRollbackSeen = occupancy_getNumRollback(occupancyPtr);
+        occupancy_fillGrid(occupancyPtr, myGridPtr, &gridMin, &gridMax);
+    }
+    assert(gridPtr->numPoint <= (long)UINT32_MAX); /* indexqueue holds 32-bit indices */
+    long queueEstimate = ((routerPtr->expansion == ROUTER_EXPANSION_LEE) ?
+                          getQueueEstimate(gridPtr) : 1);
+    myWorkspace.queuePtr = indexqueue_alloc(queueEstimate);
+    myWorkspace.heapPtr = heap_alloc(-1);
+    long maxCost = routerPtr->xCost;
+    maxCost = ((routerPtr->yCost > maxCost) ? routerPtr->yCost : maxCost);
+    maxCost = ((routerPtr->zCost > maxCost) ? routerPtr->zCost : maxCost);
+    myWorkspace.bucketQueuePtr = bucketqueue_alloc(maxCost);
+    myWorkspace.dstBucketQueuePtr = bucketqueue_alloc((routerPtr->expansion == ROUTER_EXPANSION_BIDIR) ?
+                                                      maxCost : 0);
+    myWorkspace.meetVectorPtr = indexvector_alloc(1);
+    /* Paths up to PATH_NUM_INLINE_POINT long trace into the inline buffer */
+    myWorkspace.traceVectorPtr = indexvector_alloc(1);
+    myWorkspace.snapshotVersions = (unsigned long*)malloc(occupancyPtr->numRegion * sizeof(unsigned long));
+    myWorkspace.regionVectorPtr = indexvector_alloc(1);
+    myWorkspace.repairVectorPtr = indexvector_alloc(1);
+    myWorkspace.astarVectorPtr = coordinatevector_alloc(1);
+    assert(myWorkspace.astarVectorPtr);
+    assert(myWorkspace.queuePtr && myWorkspace.heapPtr &&
+           myWorkspace.bucketQueuePtr && myWorkspace.dstBucketQueuePtr &&
+           myWorkspace.meetVectorPtr && myWorkspace.traceVectorPtr &&
+           myWorkspace.snapshotVersions && myWorkspace.regionVectorPtr &&
+           myWorkspace.repairVectorPtr);
+    if (routerPtr->expansion == ROUTER_EXPANSION_PARALLEL) {
+        myWorkspace.wavefrontPtr = wavefront_alloc(routerPtr->numExpansionThread,
+                                                   routerPtr->xCost,
+                                                   routerPtr->yCost,
+                                                   routerPtr->zCost);
+        assert(myWorkspace.wavefrontPtr);
+    } else if (routerPtr->expansion == ROUTER_EXPANSION_BITWAVE) {
+        myWorkspace.bitwavePtr = bitwave_alloc(routerPtr->xCost,
+                                               routerPtr->yCost,
+                                               routerPtr->zCost);
+        assert(myWorkspace.bitwavePtr);
+        myWorkspace.occupancyPtr = occupancyPtr;
+    } else if (routerPtr->expansion == ROUTER_EXPANSION_BATCH) {
+        myWorkspace.multiwavePtr = multiwave_alloc(gridPtr->width,
+                                                   gridPtr->height,
+                                                   gridPtr->depth,
+                                                   routerPtr->xCost,
+                                                   routerPtr->yCost,
+                                                   routerPtr->zCost);
+        assert(myWorkspace.multiwavePtr);
+        /* Drains the work pool, so the loop below finds it empty */
+        routeBatches(routerPtr, mazePtr, workpoolPtr, myId, &myWorkspace, myPathVectorPtr, lockPtr, combinerPtr);
+    } else if (routerPtr->expansion == ROUTER_EXPANSION_AKERS) {
+        myWorkspace.akersPtr = akers_alloc();
+        assert(myWorkspace.akersPtr);
+        myWorkspace.occupancyPtr = occupancyPtr;
+    }
 
     /*
      * Iterate over work list to route each path. This involves an
@@ -316,59 +2181,152 @@ void router_solve (void* argPtr){
      */
     while (1) {
 
-        pair_t* coordinatePairPtr;
-        pthread_mutex_lock(lockPtr);
-        if (queue_isEmpty(workQueuePtr)) {
-            coordinatePairPtr = NULL;
-        } else {
-            coordinatePairPtr = (pair_t*)queue_pop(workQueuePtr);
-        }
-        pthread_mutex_unlock(lockPtr);
+        long priority;
+        pair_t* coordinatePairPtr = (pair_t*)workpool_pop(workpoolPtr, myId, &priority);
         if (coordinatePairPtr == NULL) {
             break;
         }
 
         coordinate_t* srcPtr = coordinatePairPtr->firstPtr;
         coordinate_t* dstPtr = coordinatePairPtr->secondPtr;
+        bool_t isPushedBack = FALSE;
 
-        pair_free(coordinatePairPtr);
+        long margin = routerPtr->windowMargin;
+        if (isWindowGrid && margin < 0) {
+            margin = 0; /* the whole grid does not fit; widen from the bounding box */
+        }
+        long lastMargin = -1; /* window grid: the margin of the last attempt */
+        long numWiden = 0;
+        long numRepair = 0;
+        setWindow(&myWorkspace.window, gridPtr, srcPtr, dstPtr, margin);
 
         while (1) {
           bool_t success = FALSE;
-          bool_t breakSignal = FALSE;
-          vector_t* pointVectorPtr = NULL;
+          indexvector_t* pointVectorPtr = myWorkspace.traceVectorPtr;
+          path_t* pathPtr = NULL;
 
           //pensar
-          grid_copy(myGridPtr, gridPtr); /* create a copy of the grid, over which the expansion and trace back phases will be executed. */
-          if (doExpansion(routerPtr, myGridPtr, myExpansionQueuePtr,
-                           srcPtr, dstPtr)) {
-              pointVectorPtr = doTraceback(gridPtr, myGridPtr, dstPtr, bendCost);
-              if (pointVectorPtr) {
-                  pthread_mutex_lock(lockPtr);
-                  //verificar se o caminho esta livre
-                  long i;
-                  for (i = 1; i < vector_getSize(pointVectorPtr) - 1; i++) {
-                    if (*(long*)vector_at(pointVectorPtr, i) != -1) {  
-                      breakSignal = TRUE;
+          bool_t isResumed = myWorkspace.isResumed;
+          if (!isResumed) {
+              /* Akers reads the occupancy itself, after this too */
+              occupancy_readVersions(occupancyPtr, myWorkspace.snapshotVersions);
+          }
+          if (isResumed) {
+              /* repairLabels brought the labels up to date */
+          } else if (isWindowGrid) {
+              if (!grid_setWindow(myGridPtr, &myWorkspace.window.min, &myWorkspace.window.max)) {
+                  /* Over the ceiling: settle for the widest window that still fits */
+                  margin = fitWindow(&myWorkspace.window, gridPtr, srcPtr, dstPtr,
+                                     lastMargin + 1, margin - 1, maxPoint);
+                  if (margin < 0) {
+                      /* Nothing wider than the last attempt fits: unroutable under the ceiling */
+                      myWorkspace.stats.numOverCeiling++;
                       break;
-                    }
                   }
-                  if (breakSignal) {
-                    pthread_mutex_unlock(lockPtr);
-                    continue;
+                  bool_t status = grid_setWindow(myGridPtr, &myWorkspace.window.min, &myWorkspace.window.max);
+                  assert(status);
+              }
+              lastMargin = margin;
+              occupancy_fillGrid(occupancyPtr, myGridPtr, &myWorkspace.window.min, &myWorkspace.window.max);
+              myWorkspace.numDirty = 0;
+              myWorkspace.stats.numPrivateByte = MAX(myWorkspace.stats.numPrivateByte,
+                                                     (myGridPtr->numPoint + 1) * numBytePerPoint);
+          } else if (isDirtyReset) {
+              resetWindow(occupancyPtr, myGridPtr, &myWorkspace); /* the private grid the expansion and trace back phases work on */
+          } else if (myGridPtr) {
+              fillWindow(occupancyPtr, myGridPtr, &myWorkspace.window);
+          }
+          TIMER_T expansionStart;
+          TIMER_T expansionStop;
+          long numCellExpanded = myWorkspace.stats.numCellExpanded;
+          TIMER_READ(expansionStart);
+          bool_t isPathFound = doExpansion(routerPtr, myGridPtr, &myWorkspace, srcPtr, dstPtr);
+          bool_t isWide = myWorkspace.isOverflow;
+          long numWideByte = (maxPoint + 1) * numBytePerPoint + (isWide ? myGridPtr->numPoint * (long)sizeof(long) : 0);
+          bool_t isWideFitting = ((routerPtr->maxPrivateByte == 0 ||
+                                   numWideByte <= routerPtr->maxPrivateByte) ? TRUE : FALSE);
+          if (isWide && isWideFitting) {
+              /* A label outgrew a grid point: search this window again with wide labels */
+              myWorkspace.isOverflow = FALSE;
+              myWorkspace.stats.numWideRetry++;
+              myWorkspace.stats.numPrivateByte = MAX(myWorkspace.stats.numPrivateByte, numWideByte);
+              isPathFound = doWideExpansion(routerPtr, myGridPtr, &myWorkspace, srcPtr, dstPtr);
+          }
+          TIMER_READ(expansionStop);
+          myWorkspace.stats.expansionSeconds += TIMER_DIFF_SECONDS(expansionStart, expansionStop);
+          if (isWide && !isWideFitting) {
+              /* No room for wide labels under the ceiling */
+              myWorkspace.isOverflow = FALSE;
+              myWorkspace.stats.numOverCeiling++;
+              break;
+          }
+          if (isResumed) {
+              myWorkspace.stats.numCellReexpanded += myWorkspace.stats.numCellExpanded - numCellExpanded;
+          }
+          if (!isPathFound) {
+              if (isWindowWholeGrid(&myWorkspace.window, gridPtr)) {
+                  break;
+              }
+              /* Blocked inside the window: double the margin and retry */
+              margin = MAX(2 * margin, 1L);
+              numWiden++;
+              setWindow(&myWorkspace.window, gridPtr, srcPtr, dstPtr, margin);
+              continue;
+          }
+
+          TIMER_T tracebackStart;
+          TIMER_T tracebackStop;
+          TIMER_READ(tracebackStart);
+          bool_t isTraced;
+          indexvector_clear(pointVectorPtr);
+          if (isWide) {
+              isTraced = doWideTraceback(routerPtr, myGridPtr, &myWorkspace, srcPtr, dstPtr, pointVectorPtr);
+          } else if (routerPtr->expansion == ROUTER_EXPANSION_BIDIR) {
+              isTraced = doBidirTraceback(myGridPtr, &myWorkspace, bendCost, pointVectorPtr);
+          } else if (routerPtr->expansion == ROUTER_EXPANSION_AKERS) {
+              isTraced = akers_traceback(myWorkspace.akersPtr, gridPtr, pointVectorPtr);
+          } else if (routerPtr->expansion == ROUTER_EXPANSION_BITWAVE) {
+              isTraced = bitwave_traceback(myWorkspace.bitwavePtr, gridPtr, pointVectorPtr);
+          } else if (routerPtr->isPredecessorLabel) {
+              isTraced = doPredecessorTraceback(routerPtr, myGridPtr, srcPtr, dstPtr, pointVectorPtr);
+          } else {
+              isTraced = doTraceback(myGridPtr, dstPtr, bendCost, pointVectorPtr);
+          }
+          TIMER_READ(tracebackStop);
+          myWorkspace.stats.tracebackSeconds += TIMER_DIFF_SECONDS(tracebackStart, tracebackStop);
+          if (isTraced) {
+              /* Akers and bitwave trace into the shared grid, the others into their own */
+              pathPtr = path_alloc((myGridPtr ? myGridPtr : gridPtr), pointVectorPtr);
+              assert(pathPtr);
+              if (!commitPath(routerPtr, occupancyPtr, gridPtr, pathPtr, lockPtr, combinerPtr, myId, &myWorkspace)) {
+                  path_free(pathPtr);
+                  if (isRepairing && !isWide && numRepair < ROUTER_MAX_REPAIR &&
+                      repairLabels(routerPtr, occupancyPtr, myGridPtr, &myWorkspace, srcPtr))
+                  {
+                      /* Lost a point to another commit: route around it from here */
+                      numRepair++;
+                      continue;
                   }
-                  grid_addPath_Ptr(gridPtr, pointVectorPtr);
-                  pthread_mutex_unlock(lockPtr);
-                  success = TRUE;
+                  /* Lost a point to another commit: requeue at its own rank, so it
+                     keeps its place in the longest-first order */
+                  workpool_push(workpoolPtr, myId, (void*)coordinatePairPtr, priority);
+                  isPushedBack = TRUE;
+                  break;
               }
-          } else { break; }
+              success = TRUE;
+          }
 
           if (success) {
-              bool_t status = vector_pushBack(myPathVectorPtr,(void*)pointVectorPtr);
+              myWorkspace.stats.numWindowStep[MIN(numWiden, ROUTER_MAX_WINDOW_STEP - 1)]++;
+              bool_t status = vector_pushBack(myPathVectorPtr,(void*)pathPtr);
               assert(status);
               break;
           }
         }
+
+        if (!isPushedBack) {
+            pair_free(coordinatePairPtr);
+        }
     }
 
     /*
@@ -377,10 +2335,36 @@ void router_solve (void* argPtr){
     list_t* pathVectorListPtr = routerArgPtr->pathVectorListPtr;
     pthread_mutex_lock(lockPtr);
     list_insert(pathVectorListPtr, (void*)myPathVectorPtr);
+    addStats(&routerPtr->stats, &myWorkspace.stats);
     pthread_mutex_unlock(lockPtr);
 
-    grid_free(myGridPtr);
-    queue_free(myExpansionQueuePtr);
+    if (myGridPtr) {
+        grid_free(myGridPtr);
+    }
+    indexqueue_free(myWorkspace.queuePtr);
+    heap_free(myWorkspace.heapPtr);
+    bucketqueue_free(myWorkspace.bucketQueuePtr);
+    bucketqueue_free(myWorkspace.dstBucketQueuePtr);
+    indexvector_free(myWorkspace.meetVectorPtr);
+    indexvector_free(myWorkspace.traceVectorPtr);
+    indexvector_free(myWorkspace.regionVectorPtr);
+    indexvector_free(myWorkspace.repairVectorPtr);
+    coordinatevector_free(myWorkspace.astarVectorPtr);
+    free(myWorkspace.snapshotVersions);
+    free(myWorkspace.dirtyIndices);
+    free(myWorkspace.wideLabels);
+    if (myWorkspace.wavefrontPtr) {
+        wavefront_free(myWorkspace.wavefrontPtr);
+    }
+    if (myWorkspace.bitwavePtr) {
+        bitwave_free(myWorkspace.bitwavePtr);
+    }
+    if (myWorkspace.multiwavePtr) {
+        multiwave_free(myWorkspace.multiwavePtr);
+    }
+    if (myWorkspace.akersPtr) {
+        akers_free(myWorkspace.akersPtr);
+    }
 }
 
 
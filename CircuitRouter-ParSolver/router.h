@@ -55,22 +55,89 @@
 #define ROUTER_H 1
 
 
+#include "combiner.h"
 #include "grid.h"
 #include "maze.h"
 #include "lib/vector.h"
+#include "workpool.h"
+
+typedef enum router_expansion {
+    ROUTER_EXPANSION_LEE   = 0, /* breadth-first flood over a FIFO queue */
+    ROUTER_EXPANSION_ASTAR = 1, /* best-first by value + Manhattan estimate */
+    ROUTER_EXPANSION_BIDIR = 2, /* Dijkstra from both ends until no shorter junction remains */
+    ROUTER_EXPANSION_DIAL  = 3, /* Dijkstra order over a bucket queue */
+    ROUTER_EXPANSION_PARALLEL = 4, /* level-synchronous, one net per thread team */
+    ROUTER_EXPANSION_BITWAVE  = 5, /* Lee over bitsets, a row of points per instruction */
+    ROUTER_EXPANSION_BATCH    = 6, /* breadth-first for up to 64 nets with windows apart, a bit each */
+    ROUTER_EXPANSION_AKERS    = 7, /* Lee over a 2-bit private grid (Akers' coding) */
+    ROUTER_NUM_EXPANSION
+} router_expansion_t;
+
+typedef enum router_commit {
+    ROUTER_COMMIT_LOCK = 0, /* check then mark the path under the shared mutex */
+    ROUTER_COMMIT_CAS  = 1, /* claim point by point with atomics, roll back on conflict */
+    ROUTER_COMMIT_STM  = 2, /* check and mark in a GCC transaction (make TM=gnu) */
+    ROUTER_COMMIT_COMBINE = 3, /* flat combining: one thread checks and marks all pending paths */
+    ROUTER_NUM_COMMIT
+} router_commit_t;
+
+enum router_config {
+    ROUTER_MAX_WINDOW_STEP = 32,
+    ROUTER_PRED_SHIFT      = 3, /* low label bits holding the arriving grid move */
+    ROUTER_DIRTY_DENSITY   = 8, /* refill a window once 1 in this many of its points is dirty */
+    ROUTER_NUM_LATENCY_BUCKET = 16, /* commit latency histogram: powers of two microseconds */
+    ROUTER_MAX_REPAIR      = 4, /* lost commits repaired per net before it goes back to the pool */
+    ROUTER_BATCH_MARGIN    = 2, /* batch: window margin of a net without -w; lanes keep windows apart */
+};
+
+typedef struct router_stats {
+    long numExpansion;     /* calls to doExpansion */
+    long numCellExpanded;  /* grid points popped and expanded */
+    long numCellRelabeled; /* labeled points given a smaller value */
+    long numCellSkipped;   /* stale entries popped and discarded unexpanded */
+    long numCellReset;     /* private grid points restored between attempts */
+    long numRepair;        /* lost commits whose labels were repaired in place */
+    long numCellKept;      /* labels those repairs left standing */
+    long numCellReexpanded; /* points expanded after those repairs */
+    long numWindowStep[ROUTER_MAX_WINDOW_STEP]; /* routed nets by widenings needed */
+    long numLevel;         /* parallel, bitwave, batch: synchronous levels or waves run */
+    long numBatch;         /* batch: multi-net expansions */
+    long numPrivateByte;   /* largest private grid of one thread */
+    long numOverCeiling;   /* nets no window under maxPrivateByte could route */
+    long numWideRetry;     /* expansions redone on wide labels: a label outgrew a grid point */
+    long numCommitted;     /* paths added to the occupancy */
+    long numConflict;      /* commits refused: a point was taken first */
+    long numAttempt;       /* stm: transaction runs, aborted ones included */
+    long numUnvalidated;   /* lock: commits whose regions had not changed */
+    long numEarlyRestart;  /* commits given up before locking or claiming */
+    long numCommitLatency[ROUTER_NUM_LATENCY_BUCKET]; /* commits taking under 2^b us; the last bucket takes the rest */
+    double commitSeconds;  /* summed over threads: time in commitPath */
+    double expansionSeconds; /* summed over threads: time in doExpansion */
+    double tracebackSeconds; /* summed over threads: time tracing paths back */
+} router_stats_t;
 
 typedef struct router {
     long xCost;
     long yCost;
     long zCost;
     long bendCost;
+    router_expansion_t expansion;
+    long windowMargin;    /* search window around src/dst; < 0 is the whole grid */
+    long numExpansionThread; /* parallel: team size expanding each net */
+    bool_t isPredecessorLabel; /* lee, dial: labels record the arriving move */
+    long maxPrivateByte;  /* ceiling on each thread's private grid; 0 is none */
+    router_commit_t commit;
+    bool_t isRepairing;   /* lee: repair the labels after a lost commit instead of starting over */
+    router_stats_t stats; /* summed over all threads as they finish */
 } router_t;
 
 typedef struct router_solve_arg {
     router_t* routerPtr;
     maze_t* mazePtr;
     list_t* pathVectorListPtr;
-    pthread_mutex_t* lockPtr;
+    pthread_mutex_t* lockPtr; /* guards commits and pathVectorListPtr */
+    workpool_t* workpoolPtr;  /* the nets to route, a deque per thread */
+    combiner_t* combinerPtr;  /* combine commits: a publication slot per thread */
 } router_solve_arg_t;
 
 
@@ -88,6 +155,76 @@ router_t* router_alloc (long xCost, long yCost, long zCost, long bendCost);
 void router_free (router_t* routerPtr);
 
 
+/* =============================================================================
+ * router_parseExpansion
+ * -- Returns FALSE if 'name' is not a known expansion engine
+ * =============================================================================
+ */
+bool_t router_parseExpansion (const char* name, router_expansion_t* expansionPtr);
+
+
+/* =============================================================================
+ * router_getExpansionName
+ * =============================================================================
+ */
+const char* router_getExpansionName (router_expansion_t expansion);
+
+
+/* =============================================================================
+ * router_parseCommit
+ * -- Returns FALSE if 'name' is not a known commit mode
+ * =============================================================================
+ */
+bool_t router_parseCommit (const char* name, router_commit_t* commitPtr);
+
+
+/* =============================================================================
+ * router_getCommitName
+ * =============================================================================
+ */
+const char* router_getCommitName (router_commit_t commit);
+
+
+/* =============================================================================
+ * router_isCommitSupported
+ * -- TRUE if this build can commit with 'commit'
+ * =============================================================================
+ */
+bool_t router_isCommitSupported (router_commit_t commit);
+
+
+/* =============================================================================
+ * router_isPredecessorSupported
+ * -- TRUE if 'expansion' can record the arriving move in its labels
+ * =============================================================================
+ */
+bool_t router_isPredecessorSupported (router_expansion_t expansion);
+
+
+/* =============================================================================
+ * router_isRepairSupported
+ * -- TRUE if 'expansion' can repair its labels after a lost commit
+ * =============================================================================
+ */
+bool_t router_isRepairSupported (router_expansion_t expansion);
+
+
+/* =============================================================================
+ * router_isWindowGridSupported
+ * -- TRUE if 'expansion' can work on a private grid covering only the search
+ *    window, which is what lets maxPrivateByte bound it
+ * =============================================================================
+ */
+bool_t router_isWindowGridSupported (router_expansion_t expansion);
+
+
+/* =============================================================================
+ * router_printStats
+ * =============================================================================
+ */
+void router_printStats (router_t* routerPtr, FILE* file);
+
+
 /* =============================================================================
  * router_solve
  * =============================================================================
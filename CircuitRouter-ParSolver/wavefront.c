@@ -0,0 +1,442 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * wavefront.c
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "coordinate.h"
+#include "grid.h"
+#include "lib/types.h"
+#include "wavefront.h"
+
+
+/*
+ * Level-synchronous expansion of one net by a team of threads.
+ *
+ * Distances are integers and every move costs at least 1, so processing
+ * levels L = 0, 1, 2, ... in order settles each point at its exact distance
+ * (delta-stepping with delta = 1). Level L is the set of entries that
+ * earlier levels relaxed into bucket L and that still hold L.
+ *
+ * Every level has two barriers: one before the frontier is read, so everybody
+ * sees the same frontier and destination state, and one after relaxation, so
+ * the bucket sizes used for the termination test are stable.
+ */
+
+enum wavefront_config {
+    WAVEFRONT_LIST_INIT_CAPACITY = 256,
+};
+
+typedef struct cell_list {
+    grid_point_t** elements;
+    long size;
+    long capacity;
+} cell_list_t;
+
+typedef struct member {
+    cell_list_t* buckets;  /* level L is pushed to buckets[L % numBucket] */
+    wavefront_stats_t stats;
+    char padding[64];      /* keep members' hot fields on separate lines */
+} member_t;
+
+struct wavefront {
+    long numThread;
+    long costs[3];         /* x, y, z */
+    long numBucket;        /* largest cost + 1 */
+    member_t* members;
+    pthread_t* threads;
+    pthread_barrier_t barrier;
+    bool_t isDone;         /* helpers exit at the next start barrier */
+    /* current job, written by the caller before the start barrier */
+    grid_t* gridPtr;
+    grid_point_t* dstGridPointPtr;
+    bool_t isPathFound;
+};
+
+typedef struct helper_arg {
+    wavefront_t* wavefrontPtr;
+    long rank;
+} helper_arg_t;
+
+
+/* =============================================================================
+ * pushCell
+ * =============================================================================
+ */
+static inline void pushCell (cell_list_t* listPtr, grid_point_t* gridPointPtr){
+    if (listPtr->size == listPtr->capacity) {
+        long newCapacity = 2 * listPtr->capacity;
+        grid_point_t** newElements = (grid_point_t**)realloc(listPtr->elements, newCapacity * sizeof(grid_point_t*));
+        assert(newElements);
+        listPtr->elements = newElements;
+        listPtr->capacity = newCapacity;
+    }
+    listPtr->elements[listPtr->size++] = gridPointPtr;
+}
+
+
+/* =============================================================================
+ * initList
+ * =============================================================================
+ */
+static void initList (cell_list_t* listPtr){
+    listPtr->elements = (grid_point_t**)malloc(WAVEFRONT_LIST_INIT_CAPACITY * sizeof(grid_point_t*));
+    assert(listPtr->elements);
+    listPtr->size = 0;
+    listPtr->capacity = WAVEFRONT_LIST_INIT_CAPACITY;
+}
+
+
+/* =============================================================================
+ * relax
+ * -- Lowers *gridPointPtr to 'value' unless it is full or already as low
+ * =============================================================================
+ */
+static inline void relax (member_t* memberPtr, long numBucket, grid_point_t* gridPointPtr, long value){
+    grid_point_t old = __atomic_load_n(gridPointPtr, __ATOMIC_RELAXED);
+    while (1) {
+        if (old == GRID_POINT_FULL || (old != GRID_POINT_EMPTY && old <= value)) {
+            return;
+        }
+        if (__atomic_compare_exchange_n(gridPointPtr, &old, value, FALSE,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+    if (old != GRID_POINT_EMPTY) {
+        memberPtr->stats.numCellRelabeled++;
+    }
+    pushCell(&memberPtr->buckets[value % numBucket], gridPointPtr);
+}
+
+
+/* =============================================================================
+ * relaxNeighbors
+ * -- No window test: the shell around the window is full, and relax leaves
+ *    full points alone
+ * =============================================================================
+ */
+static void relaxNeighbors (wavefront_t* wavefrontPtr, member_t* memberPtr, grid_point_t* gridPointPtr, long value){
+    grid_t* gridPtr = wavefrontPtr->gridPtr;
+    grid_point_t* points = gridPtr->points;
+    long* costs = wavefrontPtr->costs;
+    long numBucket = wavefrontPtr->numBucket;
+    long index = gridPointPtr - points;
+
+    memberPtr->stats.numCellExpanded++;
+
+    relax(memberPtr, numBucket, &points[grid_getNeighborIndex(gridPtr, index, GRID_MOVE_POSX)], value + costs[0]);
+    relax(memberPtr, numBucket, &points[grid_getNeighborIndex(gridPtr, index, GRID_MOVE_NEGX)], value + costs[0]);
+    relax(memberPtr, numBucket, &points[grid_getNeighborIndex(gridPtr, index, GRID_MOVE_POSY)], value + costs[1]);
+    relax(memberPtr, numBucket, &points[grid_getNeighborIndex(gridPtr, index, GRID_MOVE_NEGY)], value + costs[1]);
+    relax(memberPtr, numBucket, &points[grid_getNeighborIndex(gridPtr, index, GRID_MOVE_POSZ)], value + costs[2]);
+    relax(memberPtr, numBucket, &points[grid_getNeighborIndex(gridPtr, index, GRID_MOVE_NEGZ)], value + costs[2]);
+}
+
+
+/* =============================================================================
+ * relaxBucket
+ * -- This member's slice of the concatenated level buckets
+ * =============================================================================
+ */
+static void relaxBucket (wavefront_t* wavefrontPtr, member_t* memberPtr, long rank, long level, long frontierSize){
+    long numThread = wavefrontPtr->numThread;
+    long b = level % wavefrontPtr->numBucket;
+    long begin = (frontierSize * rank) / numThread;
+    long end = (frontierSize * (rank + 1)) / numThread;
+    long offset = 0;
+    long t;
+
+    for (t = 0; t < numThread && offset < end; t++) {
+        cell_list_t* listPtr = &wavefrontPtr->members[t].buckets[b];
+        long i = ((begin > offset) ? (begin - offset) : 0);
+        for (; i < listPtr->size && offset + i < end; i++) {
+            grid_point_t* gridPointPtr = listPtr->elements[i];
+            if (__atomic_load_n(gridPointPtr, __ATOMIC_RELAXED) != level) {
+                continue; /* stale: relabeled lower since it was pushed */
+            }
+            relaxNeighbors(wavefrontPtr, memberPtr, gridPointPtr, level);
+        }
+        offset += listPtr->size;
+    }
+}
+
+
+/* =============================================================================
+ * sumBucket
+ * =============================================================================
+ */
+static long sumBucket (wavefront_t* wavefrontPtr, long b){
+    long size = 0;
+    long t;
+    for (t = 0; t < wavefrontPtr->numThread; t++) {
+        size += wavefrontPtr->members[t].buckets[b].size;
+    }
+    return size;
+}
+
+
+/* =============================================================================
+ * expandLevels
+ * -- Run by every member of the team; all control decisions are made from
+ *    state read right after a barrier, so every member takes the same branch
+ * =============================================================================
+ */
+static void expandLevels (wavefront_t* wavefrontPtr, long rank){
+    member_t* memberPtr = &wavefrontPtr->members[rank];
+    long numBucket = wavefrontPtr->numBucket;
+    long maxLevel = (long)GRID_POINT_MAX - (numBucket - 1);
+    long level;
+    long b;
+
+    for (level = GRID_POINT_ORIGIN; ; level++) {
+
+        /* Frontier */
+        pthread_barrier_wait(&wavefrontPtr->barrier);
+
+        long frontierSize = sumBucket(wavefrontPtr, level % numBucket);
+        if (*wavefrontPtr->dstGridPointPtr == level) {
+            if (rank == 0) {
+                wavefrontPtr->isPathFound = TRUE;
+            }
+            break;
+        }
+        if (level > maxLevel) {
+            /* Its neighbors' labels would not fit a grid point */
+            if (rank == 0) {
+                memberPtr->stats.numOverflow++;
+            }
+            break;
+        }
+        if (rank == 0) {
+            memberPtr->stats.numLevel++;
+        }
+
+        /* Relaxation */
+        relaxBucket(wavefrontPtr, memberPtr, rank, level, frontierSize);
+        pthread_barrier_wait(&wavefrontPtr->barrier);
+
+        /* Termination; only this level's bucket is cleared */
+        long pending = 0;
+        for (b = 0; b < numBucket; b++) {
+            if (b != level % numBucket) {
+                pending += sumBucket(wavefrontPtr, b);
+            }
+        }
+        if (pending == 0) {
+            break;
+        }
+        memberPtr->buckets[level % numBucket].size = 0;
+    }
+
+    for (b = 0; b < numBucket; b++) {
+        memberPtr->buckets[b].size = 0;
+    }
+}
+
+
+/* =============================================================================
+ * helperThread
+ * =============================================================================
+ */
+static void* helperThread (void* argPtr){
+    helper_arg_t* helperArgPtr = (helper_arg_t*)argPtr;
+    wavefront_t* wavefrontPtr = helperArgPtr->wavefrontPtr;
+    long rank = helperArgPtr->rank;
+    free(helperArgPtr);
+
+    while (1) {
+        pthread_barrier_wait(&wavefrontPtr->barrier); /* job published */
+        if (wavefrontPtr->isDone) {
+            break;
+        }
+        expandLevels(wavefrontPtr, rank);
+        pthread_barrier_wait(&wavefrontPtr->barrier); /* job finished */
+    }
+
+    return NULL;
+}
+
+
+/* =============================================================================
+ * wavefront_alloc
+ * -- Starts numThread-1 helper threads; the caller of wavefront_expand is the
+ *    remaining member of the team
+ * -- All costs must be >= 1
+ * =============================================================================
+ */
+wavefront_t* wavefront_alloc (long numThread, long xCost, long yCost, long zCost){
+    wavefront_t* wavefrontPtr;
+
+    assert(xCost >= 1 && yCost >= 1 && zCost >= 1);
+    numThread = ((numThread < 1) ? 1 : numThread);
+
+    wavefrontPtr = (wavefront_t*)malloc(sizeof(wavefront_t));
+    if (wavefrontPtr) {
+        wavefrontPtr->numThread = numThread;
+        wavefrontPtr->costs[0] = xCost;
+        wavefrontPtr->costs[1] = yCost;
+        wavefrontPtr->costs[2] = zCost;
+        long maxCost = xCost;
+        maxCost = ((yCost > maxCost) ? yCost : maxCost);
+        maxCost = ((zCost > maxCost) ? zCost : maxCost);
+        wavefrontPtr->numBucket = maxCost + 1;
+        wavefrontPtr->isDone = FALSE;
+
+        wavefrontPtr->members = (member_t*)calloc(numThread, sizeof(member_t));
+        assert(wavefrontPtr->members);
+        long t;
+        for (t = 0; t < numThread; t++) {
+            member_t* memberPtr = &wavefrontPtr->members[t];
+            memberPtr->buckets = (cell_list_t*)malloc(wavefrontPtr->numBucket * sizeof(cell_list_t));
+            assert(memberPtr->buckets);
+            long b;
+            for (b = 0; b < wavefrontPtr->numBucket; b++) {
+                initList(&memberPtr->buckets[b]);
+            }
+        }
+
+        pthread_barrier_init(&wavefrontPtr->barrier, NULL, numThread);
+        wavefrontPtr->threads = (pthread_t*)malloc(numThread * sizeof(pthread_t));
+        assert(wavefrontPtr->threads);
+        for (t = 1; t < numThread; t++) {
+            helper_arg_t* helperArgPtr = (helper_arg_t*)malloc(sizeof(helper_arg_t));
+            assert(helperArgPtr);
+            helperArgPtr->wavefrontPtr = wavefrontPtr;
+            helperArgPtr->rank = t;
+            pthread_create(&wavefrontPtr->threads[t], NULL, helperThread, (void*)helperArgPtr);
+        }
+    }
+
+    return wavefrontPtr;
+}
+
+
+/* =============================================================================
+ * wavefront_free
+ * -- Stops and joins the helper threads
+ * =============================================================================
+ */
+void wavefront_free (wavefront_t* wavefrontPtr){
+    long t;
+
+    wavefrontPtr->isDone = TRUE;
+    pthread_barrier_wait(&wavefrontPtr->barrier);
+    for (t = 1; t < wavefrontPtr->numThread; t++) {
+        pthread_join(wavefrontPtr->threads[t], NULL);
+    }
+    pthread_barrier_destroy(&wavefrontPtr->barrier);
+
+    for (t = 0; t < wavefrontPtr->numThread; t++) {
+        member_t* memberPtr = &wavefrontPtr->members[t];
+        long b;
+        for (b = 0; b < wavefrontPtr->numBucket; b++) {
+            free(memberPtr->buckets[b].elements);
+        }
+        free(memberPtr->buckets);
+    }
+    free(wavefrontPtr->members);
+    free(wavefrontPtr->threads);
+    free(wavefrontPtr);
+}
+
+
+/* =============================================================================
+ * wavefront_expand
+ * -- Labels myGridPtr with distances from srcPtr until dstPtr is settled.
+ *    Every label is exact, so the result can be traced back like a Lee
+ *    expansion.
+ * -- A window must be closed off by GRID_POINT_FULL points around it
+ * -- Returns TRUE if dstPtr was reached; FALSE with statsPtr->numOverflow
+ *    raised if it stopped short because labels outgrew a grid point
+ * =============================================================================
+ */
+bool_t wavefront_expand (wavefront_t* wavefrontPtr, grid_t* myGridPtr, coordinate_t* srcPtr, coordinate_t* dstPtr, wavefront_stats_t* statsPtr){
+    long t;
+
+    wavefrontPtr->gridPtr = myGridPtr;
+    wavefrontPtr->isPathFound = FALSE;
+    grid_setPoint(myGridPtr, srcPtr->x, srcPtr->y, srcPtr->z, GRID_POINT_ORIGIN);
+    grid_setPoint(myGridPtr, dstPtr->x, dstPtr->y, dstPtr->z, GRID_POINT_EMPTY);
+    wavefrontPtr->dstGridPointPtr = grid_getPointRef(myGridPtr, dstPtr->x, dstPtr->y, dstPtr->z);
+    pushCell(&wavefrontPtr->members[0].buckets[GRID_POINT_ORIGIN % wavefrontPtr->numBucket],
+             grid_getPointRef(myGridPtr, srcPtr->x, srcPtr->y, srcPtr->z));
+
+    if (wavefrontPtr->numThread > 1) {
+        pthread_barrier_wait(&wavefrontPtr->barrier); /* job published */
+    }
+    expandLevels(wavefrontPtr, 0);
+    if (wavefrontPtr->numThread > 1) {
+        pthread_barrier_wait(&wavefrontPtr->barrier); /* job finished */
+    }
+
+    for (t = 0; t < wavefrontPtr->numThread; t++) {
+        wavefront_stats_t* memberStatsPtr = &wavefrontPtr->members[t].stats;
+        statsPtr->numCellExpanded  += memberStatsPtr->numCellExpanded;
+        statsPtr->numCellRelabeled += memberStatsPtr->numCellRelabeled;
+        statsPtr->numLevel         += memberStatsPtr->numLevel;
+        statsPtr->numOverflow      += memberStatsPtr->numOverflow;
+        memset(memberStatsPtr, 0, sizeof(wavefront_stats_t));
+    }
+
+    return wavefrontPtr->isPathFound;
+}
+
+
+/* =============================================================================
+ *
+ * End of wavefront.c
+ *
+ * =============================================================================
+ */
@@ -0,0 +1,111 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * wavefront.h
+ *
+ * =============================================================================
+ */
+
+
+#ifndef WAVEFRONT_H
+#define WAVEFRONT_H 1
+
+
+#include "coordinate.h"
+#include "grid.h"
+#include "lib/types.h"
+
+typedef struct wavefront wavefront_t;
+
+typedef struct wavefront_stats {
+    long numCellExpanded;  /* points whose neighbors were relaxed */
+    long numCellRelabeled; /* labeled points given a smaller value */
+    long numLevel;         /* distance levels processed */
+    long numOverflow;      /* expansions stopped: the next labels would not fit a grid point */
+} wavefront_stats_t;
+
+
+/* =============================================================================
+ * wavefront_alloc
+ * -- Starts numThread-1 helper threads; the caller of wavefront_expand is the
+ *    remaining member of the team
+ * -- All costs must be >= 1
+ * =============================================================================
+ */
+wavefront_t* wavefront_alloc (long numThread, long xCost, long yCost, long zCost);
+
+
+/* =============================================================================
+ * wavefront_free
+ * -- Stops and joins the helper threads
+ * =============================================================================
+ */
+void wavefront_free (wavefront_t* wavefrontPtr);
+
+
+/* =============================================================================
+ * wavefront_expand
+ * -- Labels myGridPtr with distances from srcPtr until dstPtr is settled.
+ *    Every label is exact, so the result can be traced back like a Lee
+ *    expansion.
+ * -- A window must be closed off by GRID_POINT_FULL points around it
+ * -- Returns TRUE if dstPtr was reached; FALSE with statsPtr->numOverflow
+ *    raised if it stopped short because labels outgrew a grid point
+ * =============================================================================
+ */
+bool_t wavefront_expand (wavefront_t* wavefrontPtr, grid_t* myGridPtr, coordinate_t* srcPtr, coordinate_t* dstPtr, wavefront_stats_t* statsPtr);
+
+
+#endif /* WAVEFRONT_H */
+
+
+/* =============================================================================
+ *
+ * End of wavefront.h
+ *
+ * =============================================================================
+ */
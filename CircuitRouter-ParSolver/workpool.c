@@ -0,0 +1,635 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * workpool.c
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lib/queue.h"
+#include "lib/types.h"
+#include "lib/vector.h"
+#include "workpool.h"
+
+
+/*
+ * The work is all known up front and sorted best (longest) first; the pool
+ * kinds trade how closely they keep that order for how little they lock.
+ *
+ * fifo is the plain shared queue: exact order, one mutex for every pop.
+ *
+ * deque gives each thread a Chase-Lev deque. The owner pops at the bottom
+ * with plain loads and stores, paying for a CAS only when it races a thief
+ * for the last item; thieves take from the top with a CAS on 'top'. Items
+ * are dealt round robin and each deque is filled in reverse, so its bottom
+ * holds its best item and owners still go best first. A thief takes the
+ * top of the fullest deque: that thread is furthest behind, so its worst
+ * item is the best any top has to offer, and its owner's order is intact.
+ * Items pushed back go to the pusher's bottom, so it retries them next.
+ * A deque can hold every item, so its ring never grows.
+ *
+ * multi is a MultiQueue: WORKPOOL_MULTI_FACTOR locked max-heaps per thread.
+ * A pop reads the top priority of two random heaps without locking, takes
+ * the better one if its trylock succeeds and otherwise draws again. Pops
+ * stay close to the global order (the rank error is O(number of heaps) in
+ * expectation) while two threads rarely want the same lock. Pushes go to a
+ * random heap at whatever priority the caller chose.
+ */
+
+typedef struct deque {
+    long top;              /* next item to steal; only grows, by CAS */
+    char topPadding[64];   /* thieves hammer 'top'; keep it off the owner's line */
+    long bottom;           /* one past the owner's next item */
+    long mask;             /* ring capacity - 1 */
+    void** elements;
+    long* priorities;
+} deque_t;
+
+typedef struct entry {
+    long priority;
+    void* dataPtr;
+} entry_t;
+
+typedef struct pqueue {
+    pthread_mutex_t lock;
+    long topPriority;      /* LONG_MIN when empty; read unlocked to pick a heap */
+    entry_t* entries;      /* max-heap on priority */
+    long size;
+    long capacity;
+    char padding[64];
+} pqueue_t;
+
+typedef struct member {
+    deque_t deque;         /* deque only */
+    workpool_stats_t stats;
+    unsigned long seed;    /* multi: picks heaps */
+    char padding[64];      /* keep members' hot fields on separate lines */
+} member_t;
+
+struct workpool {
+    workpool_kind_t kind;
+    long numThread;
+    long numJoined;
+    member_t* members;
+    pqueue_t* pqueues;     /* multi */
+    long numPqueue;
+    queue_t* fifoPtr;      /* fifo */
+    pthread_mutex_t fifoLock;
+};
+
+static const char* kindNames[WORKPOOL_NUM_KIND] = {
+    [WORKPOOL_FIFO]  = "fifo",
+    [WORKPOOL_DEQUE] = "deque",
+    [WORKPOOL_MULTI] = "multi",
+};
+
+
+/* =============================================================================
+ * pushBottom
+ * -- Owner only; the deque is never full (see workpool_alloc)
+ * =============================================================================
+ */
+static void pushBottom (deque_t* dequePtr, void* dataPtr, long priority){
+    long bottom = __atomic_load_n(&dequePtr->bottom, __ATOMIC_RELAXED);
+    assert(bottom - __atomic_load_n(&dequePtr->top, __ATOMIC_ACQUIRE) <= dequePtr->mask);
+    __atomic_store_n(&dequePtr->elements[bottom & dequePtr->mask], dataPtr, __ATOMIC_RELAXED);
+    __atomic_store_n(&dequePtr->priorities[bottom & dequePtr->mask], priority, __ATOMIC_RELAXED);
+    __atomic_store_n(&dequePtr->bottom, bottom + 1, __ATOMIC_RELEASE);
+}
+
+
+/* =============================================================================
+ * popBottom
+ * -- Owner only
+ * =============================================================================
+ */
+static void* popBottom (deque_t* dequePtr, long* priorityPtr){
+    long bottom = __atomic_load_n(&dequePtr->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&dequePtr->bottom, bottom, __ATOMIC_RELAXED);
+    /* Publish the claim before reading 'top', or a thief could take it too */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long top = __atomic_load_n(&dequePtr->top, __ATOMIC_RELAXED);
+
+    if (top > bottom) {
+        __atomic_store_n(&dequePtr->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    void* dataPtr = __atomic_load_n(&dequePtr->elements[bottom & dequePtr->mask], __ATOMIC_RELAXED);
+    *priorityPtr = __atomic_load_n(&dequePtr->priorities[bottom & dequePtr->mask], __ATOMIC_RELAXED);
+    if (top == bottom) {
+        /* Last item: settle the race with any thief on 'top' */
+        if (!__atomic_compare_exchange_n(&dequePtr->top, &top, top + 1, FALSE,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+        {
+            dataPtr = NULL;
+        }
+        __atomic_store_n(&dequePtr->bottom, bottom + 1, __ATOMIC_RELAXED);
+    }
+
+    return dataPtr;
+}
+
+
+/* =============================================================================
+ * stealTop
+ * -- Returns NULL if the deque was empty or another thread won the item
+ * =============================================================================
+ */
+static void* stealTop (deque_t* dequePtr, long* priorityPtr){
+    long top = __atomic_load_n(&dequePtr->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long bottom = __atomic_load_n(&dequePtr->bottom, __ATOMIC_ACQUIRE);
+
+    if (top >= bottom) {
+        return NULL;
+    }
+    /* The slot may be refilled once 'top' moves on; the CAS catches that */
+    void* dataPtr = __atomic_load_n(&dequePtr->elements[top & dequePtr->mask], __ATOMIC_RELAXED);
+    long priority = __atomic_load_n(&dequePtr->priorities[top & dequePtr->mask], __ATOMIC_RELAXED);
+    if (!__atomic_compare_exchange_n(&dequePtr->top, &top, top + 1, FALSE,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+    {
+        return NULL;
+    }
+    *priorityPtr = priority;
+
+    return dataPtr;
+}
+
+
+/* =============================================================================
+ * getSize
+ * -- A racy estimate, good enough to choose a victim
+ * =============================================================================
+ */
+static long getSize (deque_t* dequePtr){
+    return (__atomic_load_n(&dequePtr->bottom, __ATOMIC_RELAXED) -
+            __atomic_load_n(&dequePtr->top, __ATOMIC_RELAXED));
+}
+
+
+/* =============================================================================
+ * popDeque
+ * =============================================================================
+ */
+static void* popDeque (workpool_t* workpoolPtr, long id, long* priorityPtr){
+    member_t* members = workpoolPtr->members;
+    member_t* myMemberPtr = &members[id];
+
+    void* dataPtr = popBottom(&myMemberPtr->deque, priorityPtr);
+    if (dataPtr) {
+        myMemberPtr->stats.numPop++;
+        return dataPtr;
+    }
+
+    while (1) {
+        deque_t* victimPtr = NULL;
+        long maxSize = 0;
+        long d;
+        for (d = 0; d < workpoolPtr->numThread; d++) {
+            long size = getSize(&members[d].deque);
+            if (d != id && size > maxSize) {
+                maxSize = size;
+                victimPtr = &members[d].deque;
+            }
+        }
+        if (victimPtr == NULL) {
+            return NULL;
+        }
+        dataPtr = stealTop(victimPtr, priorityPtr);
+        if (dataPtr) {
+            myMemberPtr->stats.numSteal++;
+            return dataPtr;
+        }
+        myMemberPtr->stats.numIdle++;
+    }
+}
+
+
+/* =============================================================================
+ * siftUp
+ * =============================================================================
+ */
+static void siftUp (entry_t* entries, long i){
+    entry_t entry = entries[i];
+    while (i > 0) {
+        long parent = (i - 1) / 2;
+        if (entries[parent].priority >= entry.priority) {
+            break;
+        }
+        entries[i] = entries[parent];
+        i = parent;
+    }
+    entries[i] = entry;
+}
+
+
+/* =============================================================================
+ * siftDown
+ * =============================================================================
+ */
+static void siftDown (entry_t* entries, long size, long i){
+    entry_t entry = entries[i];
+    while (1) {
+        long child = 2 * i + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && entries[child + 1].priority > entries[child].priority) {
+            child++;
+        }
+        if (entries[child].priority <= entry.priority) {
+            break;
+        }
+        entries[i] = entries[child];
+        i = child;
+    }
+    entries[i] = entry;
+}
+
+
+/* =============================================================================
+ * insertLocked
+ * =============================================================================
+ */
+static void insertLocked (pqueue_t* pqueuePtr, void* dataPtr, long priority){
+    if (pqueuePtr->size == pqueuePtr->capacity) {
+        long newCapacity = 2 * pqueuePtr->capacity;
+        entry_t* newEntries = (entry_t*)realloc(pqueuePtr->entries, newCapacity * sizeof(entry_t));
+        assert(newEntries);
+        pqueuePtr->entries = newEntries;
+        pqueuePtr->capacity = newCapacity;
+    }
+    entry_t entry = { priority, dataPtr };
+    pqueuePtr->entries[pqueuePtr->size] = entry;
+    siftUp(pqueuePtr->entries, pqueuePtr->size);
+    pqueuePtr->size++;
+    __atomic_store_n(&pqueuePtr->topPriority, pqueuePtr->entries[0].priority, __ATOMIC_RELAXED);
+}
+
+
+/* =============================================================================
+ * removeLocked
+ * =============================================================================
+ */
+static void* removeLocked (pqueue_t* pqueuePtr, long* priorityPtr){
+    assert(pqueuePtr->size > 0);
+    entry_t top = pqueuePtr->entries[0];
+    pqueuePtr->size--;
+    if (pqueuePtr->size > 0) {
+        pqueuePtr->entries[0] = pqueuePtr->entries[pqueuePtr->size];
+        siftDown(pqueuePtr->entries, pqueuePtr->size, 0);
+    }
+    __atomic_store_n(&pqueuePtr->topPriority,
+                     ((pqueuePtr->size > 0) ? pqueuePtr->entries[0].priority : LONG_MIN),
+                     __ATOMIC_RELAXED);
+    *priorityPtr = top.priority;
+    return top.dataPtr;
+}
+
+
+/* =============================================================================
+ * nextRandom
+ * -- xorshift64
+ * =============================================================================
+ */
+static unsigned long nextRandom (unsigned long* seedPtr){
+    unsigned long x = *seedPtr;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *seedPtr = x;
+    return x;
+}
+
+
+/* =============================================================================
+ * popMulti
+ * =============================================================================
+ */
+static void* popMulti (workpool_t* workpoolPtr, long id, long* priorityPtr){
+    member_t* myMemberPtr = &workpoolPtr->members[id];
+    pqueue_t* pqueues = workpoolPtr->pqueues;
+    long numPqueue = workpoolPtr->numPqueue;
+
+    while (1) {
+        pqueue_t* aPtr = &pqueues[nextRandom(&myMemberPtr->seed) % numPqueue];
+        pqueue_t* bPtr = &pqueues[nextRandom(&myMemberPtr->seed) % numPqueue];
+        long aPriority = __atomic_load_n(&aPtr->topPriority, __ATOMIC_RELAXED);
+        long bPriority = __atomic_load_n(&bPtr->topPriority, __ATOMIC_RELAXED);
+        pqueue_t* pqueuePtr = ((bPriority > aPriority) ? bPtr : aPtr);
+        if (aPriority == LONG_MIN && bPriority == LONG_MIN) {
+            /* Both empty: look at every heap before calling the pool empty */
+            long bestPriority = LONG_MIN;
+            long q;
+            for (q = 0; q < numPqueue; q++) {
+                long priority = __atomic_load_n(&pqueues[q].topPriority, __ATOMIC_RELAXED);
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    pqueuePtr = &pqueues[q];
+                }
+            }
+            if (bestPriority == LONG_MIN) {
+                return NULL;
+            }
+        }
+        if (pthread_mutex_trylock(&pqueuePtr->lock) != 0) {
+            myMemberPtr->stats.numIdle++;
+            continue;
+        }
+        if (pqueuePtr->size == 0) {
+            pthread_mutex_unlock(&pqueuePtr->lock);
+            myMemberPtr->stats.numIdle++;
+            continue;
+        }
+        void* dataPtr = removeLocked(pqueuePtr, priorityPtr);
+        pthread_mutex_unlock(&pqueuePtr->lock);
+        myMemberPtr->stats.numPop++;
+        return dataPtr;
+    }
+}
+
+
+/* =============================================================================
+ * workpool_alloc
+ * =============================================================================
+ */
+workpool_t* workpool_alloc (workpool_kind_t kind, long numThread, queue_t* workQueuePtr){
+    assert(numThread >= 1);
+
+    vector_t* workVectorPtr = vector_alloc(1024);
+    if (workVectorPtr == NULL) {
+        return NULL;
+    }
+    while (!queue_isEmpty(workQueuePtr)) {
+        bool_t status = vector_pushBack(workVectorPtr, queue_pop(workQueuePtr));
+        assert(status);
+    }
+    long numWork = vector_getSize(workVectorPtr);
+
+    workpool_t* workpoolPtr = (workpool_t*)calloc(1, sizeof(workpool_t));
+    assert(workpoolPtr);
+    workpoolPtr->kind = kind;
+    workpoolPtr->numThread = numThread;
+    workpoolPtr->numJoined = 0;
+    workpoolPtr->members = (member_t*)calloc(numThread, sizeof(member_t));
+    assert(workpoolPtr->members);
+    long d;
+    for (d = 0; d < numThread; d++) {
+        workpoolPtr->members[d].seed = 0x9E3779B97F4A7C15UL * (unsigned long)(d + 1);
+    }
+
+    long w;
+    if (kind == WORKPOOL_FIFO) {
+        workpoolPtr->fifoPtr = queue_alloc(numWork + 1);
+        assert(workpoolPtr->fifoPtr);
+        pthread_mutex_init(&workpoolPtr->fifoLock, NULL);
+        for (w = 0; w < numWork; w++) {
+            bool_t status = queue_push(workpoolPtr->fifoPtr, vector_at(workVectorPtr, w));
+            assert(status);
+        }
+    } else if (kind == WORKPOOL_DEQUE) {
+        /* Every item could end up pushed back onto one deque */
+        long capacity = 1;
+        while (capacity < numWork + 1) {
+            capacity *= 2;
+        }
+        for (d = 0; d < numThread; d++) {
+            deque_t* dequePtr = &workpoolPtr->members[d].deque;
+            dequePtr->elements = (void**)malloc(capacity * sizeof(void*));
+            dequePtr->priorities = (long*)malloc(capacity * sizeof(long));
+            assert(dequePtr->elements && dequePtr->priorities);
+            dequePtr->mask = capacity - 1;
+            dequePtr->top = 0;
+            dequePtr->bottom = (numWork - d + numThread - 1) / numThread;
+        }
+        for (w = 0; w < numWork; w++) {
+            /* The w-th best item; the deque's best goes to its bottom */
+            deque_t* dequePtr = &workpoolPtr->members[w % numThread].deque;
+            long slot = dequePtr->bottom - 1 - (w / numThread);
+            dequePtr->elements[slot] = vector_at(workVectorPtr, w);
+            dequePtr->priorities[slot] = numWork - w;
+        }
+    } else {
+        assert(kind == WORKPOOL_MULTI);
+        long numPqueue = numThread * WORKPOOL_MULTI_FACTOR;
+        workpoolPtr->numPqueue = numPqueue;
+        workpoolPtr->pqueues = (pqueue_t*)calloc(numPqueue, sizeof(pqueue_t));
+        assert(workpoolPtr->pqueues);
+        long q;
+        for (q = 0; q < numPqueue; q++) {
+            pqueue_t* pqueuePtr = &workpoolPtr->pqueues[q];
+            pthread_mutex_init(&pqueuePtr->lock, NULL);
+            pqueuePtr->topPriority = LONG_MIN;
+            pqueuePtr->capacity = numWork / numPqueue + 16;
+            pqueuePtr->entries = (entry_t*)malloc(pqueuePtr->capacity * sizeof(entry_t));
+            assert(pqueuePtr->entries);
+        }
+        for (w = 0; w < numWork; w++) {
+            insertLocked(&workpoolPtr->pqueues[w % numPqueue], vector_at(workVectorPtr, w), numWork - w);
+        }
+    }
+    vector_free(workVectorPtr);
+
+    return workpoolPtr;
+}
+
+
+/* =============================================================================
+ * workpool_free
+ * =============================================================================
+ */
+void workpool_free (workpool_t* workpoolPtr){
+    long d;
+    for (d = 0; d < workpoolPtr->numThread; d++) {
+        free(workpoolPtr->members[d].deque.elements);
+        free(workpoolPtr->members[d].deque.priorities);
+    }
+    free(workpoolPtr->members);
+    long q;
+    for (q = 0; q < workpoolPtr->numPqueue; q++) {
+        pthread_mutex_destroy(&workpoolPtr->pqueues[q].lock);
+        free(workpoolPtr->pqueues[q].entries);
+    }
+    free(workpoolPtr->pqueues);
+    if (workpoolPtr->fifoPtr) {
+        queue_free(workpoolPtr->fifoPtr);
+        pthread_mutex_destroy(&workpoolPtr->fifoLock);
+    }
+    free(workpoolPtr);
+}
+
+
+/* =============================================================================
+ * workpool_parseKind
+ * =============================================================================
+ */
+bool_t workpool_parseKind (const char* name, workpool_kind_t* kindPtr){
+    long k;
+    for (k = 0; k < WORKPOOL_NUM_KIND; k++) {
+        if (strcmp(name, kindNames[k]) == 0) {
+            *kindPtr = (workpool_kind_t)k;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+
+/* =============================================================================
+ * workpool_getKindName
+ * =============================================================================
+ */
+const char* workpool_getKindName (workpool_kind_t kind){
+    return kindNames[kind];
+}
+
+
+/* =============================================================================
+ * workpool_join
+ * =============================================================================
+ */
+long workpool_join (workpool_t* workpoolPtr){
+    long id = __atomic_fetch_add(&workpoolPtr->numJoined, 1, __ATOMIC_RELAXED);
+    assert(id < workpoolPtr->numThread);
+    return id;
+}
+
+
+/* =============================================================================
+ * workpool_pop
+ * =============================================================================
+ */
+void* workpool_pop (workpool_t* workpoolPtr, long id, long* priorityPtr){
+    if (workpoolPtr->kind == WORKPOOL_DEQUE) {
+        return popDeque(workpoolPtr, id, priorityPtr);
+    } else if (workpoolPtr->kind == WORKPOOL_MULTI) {
+        return popMulti(workpoolPtr, id, priorityPtr);
+    }
+
+    void* dataPtr = NULL;
+    pthread_mutex_lock(&workpoolPtr->fifoLock);
+    if (!queue_isEmpty(workpoolPtr->fifoPtr)) {
+        dataPtr = queue_pop(workpoolPtr->fifoPtr);
+    }
+    pthread_mutex_unlock(&workpoolPtr->fifoLock);
+    if (dataPtr) {
+        workpoolPtr->members[id].stats.numPop++;
+    }
+    *priorityPtr = 0;
+
+    return dataPtr;
+}
+
+
+/* =============================================================================
+ * workpool_push
+ * =============================================================================
+ */
+void workpool_push (workpool_t* workpoolPtr, long id, void* dataPtr, long priority){
+    member_t* myMemberPtr = &workpoolPtr->members[id];
+    myMemberPtr->stats.numPush++;
+
+    if (workpoolPtr->kind == WORKPOOL_DEQUE) {
+        pushBottom(&myMemberPtr->deque, dataPtr, priority);
+    } else if (workpoolPtr->kind == WORKPOOL_MULTI) {
+        pqueue_t* pqueuePtr = &workpoolPtr->pqueues[nextRandom(&myMemberPtr->seed) %
+                                                    workpoolPtr->numPqueue];
+        pthread_mutex_lock(&pqueuePtr->lock);
+        insertLocked(pqueuePtr, dataPtr, priority);
+        pthread_mutex_unlock(&pqueuePtr->lock);
+    } else {
+        pthread_mutex_lock(&workpoolPtr->fifoLock);
+        bool_t status = queue_push(workpoolPtr->fifoPtr, dataPtr);
+        assert(status);
+        pthread_mutex_unlock(&workpoolPtr->fifoLock);
+    }
+}
+
+
+/* =============================================================================
+ * workpool_printStats
+ * =============================================================================
+ */
+void workpool_printStats (workpool_t* workpoolPtr, FILE* file){
+    workpool_stats_t total;
+    memset(&total, 0, sizeof(workpool_stats_t));
+    long d;
+    for (d = 0; d < workpoolPtr->numThread; d++) {
+        workpool_stats_t* statsPtr = &workpoolPtr->members[d].stats;
+        total.numSteal += statsPtr->numSteal;
+        total.numIdle  += statsPtr->numIdle;
+        total.numPush  += statsPtr->numPush;
+    }
+    fprintf(file, "Work pool       = %s", workpool_getKindName(workpoolPtr->kind));
+    if (workpoolPtr->kind == WORKPOOL_MULTI) {
+        fprintf(file, " (%li heaps)", workpoolPtr->numPqueue);
+    }
+    fprintf(file, ": %li steals, %li idle attempts, %li pushed back\n",
+            total.numSteal, total.numIdle, total.numPush);
+    for (d = 0; d < workpoolPtr->numThread; d++) {
+        workpool_stats_t* statsPtr = &workpoolPtr->members[d].stats;
+        fprintf(file, "  thread %-7li= %li own, %li stolen, %li idle, %li pushed\n",
+                d, statsPtr->numPop, statsPtr->numSteal, statsPtr->numIdle, statsPtr->numPush);
+    }
+}
+
+
+/* =============================================================================
+ *
+ * End of workpool.c
+ *
+ * =============================================================================
+ */
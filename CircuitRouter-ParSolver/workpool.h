@@ -0,0 +1,160 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This code is an adaptation of the Lee algorithm's implementation originally included in the STAMP Benchmark
+ * by Stanford University.
+ *
+ * The original copyright notice is included below.
+ *
+  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ *
+ * workpool.h
+ *
+ * =============================================================================
+ */
+
+
+#ifndef WORKPOOL_H
+#define WORKPOOL_H 1
+
+
+#include <stdio.h>
+#include "lib/queue.h"
+#include "lib/types.h"
+
+typedef enum workpool_kind {
+    WORKPOOL_FIFO  = 0, /* one queue behind a mutex; ignores priorities */
+    WORKPOOL_DEQUE = 1, /* a Chase-Lev deque per thread, stealing when empty */
+    WORKPOOL_MULTI = 2, /* MultiQueue: locked heaps, pop the better of two */
+    WORKPOOL_NUM_KIND
+} workpool_kind_t;
+
+enum workpool_config {
+    WORKPOOL_MULTI_FACTOR = 2, /* heaps per thread */
+};
+
+typedef struct workpool workpool_t;
+
+typedef struct workpool_stats {
+    long numPop;   /* items taken from the thread's own deque, or any queue */
+    long numSteal; /* deque: items taken from another thread's deque */
+    long numIdle;  /* attempts that came back empty-handed or found a queue locked */
+    long numPush;  /* items pushed back */
+} workpool_stats_t;
+
+
+/* =============================================================================
+ * workpool_alloc
+ * -- Drains workQueuePtr, which is sorted best first, into the pool; the
+ *    items get priorities numItem down to 1 in queue order
+ * -- deque: items are dealt round robin so every deque keeps the order
+ * =============================================================================
+ */
+workpool_t* workpool_alloc (workpool_kind_t kind, long numThread, queue_t* workQueuePtr);
+
+
+/* =============================================================================
+ * workpool_free
+ * =============================================================================
+ */
+void workpool_free (workpool_t* workpoolPtr);
+
+
+/* =============================================================================
+ * workpool_parseKind
+ * -- Returns FALSE if 'name' is not a known pool kind
+ * =============================================================================
+ */
+bool_t workpool_parseKind (const char* name, workpool_kind_t* kindPtr);
+
+
+/* =============================================================================
+ * workpool_getKindName
+ * =============================================================================
+ */
+const char* workpool_getKindName (workpool_kind_t kind);
+
+
+/* =============================================================================
+ * workpool_join
+ * -- Hands each calling thread its id; call once per thread
+ * =============================================================================
+ */
+long workpool_join (workpool_t* workpoolPtr);
+
+
+/* =============================================================================
+ * workpool_pop
+ * -- Takes the next item for thread 'id' and stores its priority in
+ *    *priorityPtr (0 for fifo)
+ * -- Returns NULL when the pool is empty. Only threads holding a popped item
+ *    can push, and they pop again afterwards, so an empty pool may let the
+ *    other threads go home early but never strands an item.
+ * =============================================================================
+ */
+void* workpool_pop (workpool_t* workpoolPtr, long id, long* priorityPtr);
+
+
+/* =============================================================================
+ * workpool_push
+ * -- Returns an item popped by thread 'id' to the pool with a new priority
+ * -- fifo appends it; deque puts it on the thread's own deque, next in line
+ * =============================================================================
+ */
+void workpool_push (workpool_t* workpoolPtr, long id, void* dataPtr, long priority);
+
+
+/* =============================================================================
+ * workpool_printStats
+ * -- Call after the threads are joined
+ * =============================================================================
+ */
+void workpool_printStats (workpool_t* workpoolPtr, FILE* file);
+
+
+#endif /* WORKPOOL_H */
+
+
+/* =============================================================================
+ *
+ * End of workpool.h
+ *
+ * =============================================================================
+ */
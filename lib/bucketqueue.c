@@ -0,0 +1,316 @@
+/* =============================================================================
+ *
+ * bucketqueue.c
+ * -- Monotone bucket priority queue (Dial) for small non-negative integer keys
+ * -- Every inserted key must lie in [min, min + maxStep], where min is the key
+ *    of the last entry removed
+ *
+ * =============================================================================
+ *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * Unless otherwise noted, the following license applies to STAMP files:
+ * 
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ * 
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ * 
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include "bucketqueue.h"
+#include "types.h"
+
+
+typedef struct bucket {
+    void** elements;
+    long size;
+    long capacity;
+} bucket_t;
+
+struct bucketqueue {
+    bucket_t* buckets;  /* key k lives in buckets[k % numBucket] */
+    long numBucket;     /* maxStep + 1, so live keys never share a bucket */
+    long minKey;        /* no live entry has a smaller key */
+    long size;
+};
+
+enum config {
+    BUCKET_INIT_CAPACITY = 64,
+    BUCKET_GROWTH_FACTOR = 2,
+};
+
+
+/* =============================================================================
+ * bucketqueue_alloc
+ * -- 'maxStep' is the largest amount a key may exceed the current minimum by
+ * -- Returns NULL on failure
+ * =============================================================================
+ */
+bucketqueue_t*
+bucketqueue_alloc (long maxStep)
+{
+    bucketqueue_t* queuePtr = (bucketqueue_t*)malloc(sizeof(bucketqueue_t));
+
+    if (queuePtr) {
+        long numBucket = ((maxStep < 0) ? 1 : (maxStep + 1));
+        queuePtr->buckets = (bucket_t*)calloc(numBucket, sizeof(bucket_t));
+        if (queuePtr->buckets == NULL) {
+            free(queuePtr);
+            return NULL;
+        }
+        long b;
+        for (b = 0; b < numBucket; b++) {
+            bucket_t* bucketPtr = &queuePtr->buckets[b];
+            bucketPtr->elements = (void**)malloc(BUCKET_INIT_CAPACITY * sizeof(void*));
+            if (bucketPtr->elements == NULL) {
+                queuePtr->numBucket = b;
+                bucketqueue_free(queuePtr);
+                return NULL;
+            }
+            bucketPtr->capacity = BUCKET_INIT_CAPACITY;
+        }
+        queuePtr->numBucket = numBucket;
+        queuePtr->minKey    = 0;
+        queuePtr->size      = 0;
+    }
+
+    return queuePtr;
+}
+
+
+/* =============================================================================
+ * bucketqueue_free
+ * =============================================================================
+ */
+void
+bucketqueue_free (bucketqueue_t* queuePtr)
+{
+    long b;
+    for (b = 0; b < queuePtr->numBucket; b++) {
+        free(queuePtr->buckets[b].elements);
+    }
+    free(queuePtr->buckets);
+    free(queuePtr);
+}
+
+
+/* =============================================================================
+ * bucketqueue_isEmpty
+ * =============================================================================
+ */
+bool_t
+bucketqueue_isEmpty (bucketqueue_t* queuePtr)
+{
+    return ((queuePtr->size == 0) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * bucketqueue_clear
+ * -- Empties the queue and restarts the minimum at 'minKey'
+ * =============================================================================
+ */
+void
+bucketqueue_clear (bucketqueue_t* queuePtr, long minKey)
+{
+    long b;
+    for (b = 0; b < queuePtr->numBucket; b++) {
+        queuePtr->buckets[b].size = 0;
+    }
+    queuePtr->minKey = minKey;
+    queuePtr->size   = 0;
+}
+
+
+/* =============================================================================
+ * bucketqueue_insert
+ * -- Returns FALSE on failure
+ * =============================================================================
+ */
+bool_t
+bucketqueue_insert (bucketqueue_t* queuePtr, long key, void* dataPtr)
+{
+    assert(key >= queuePtr->minKey);
+    assert(key - queuePtr->minKey < queuePtr->numBucket);
+
+    bucket_t* bucketPtr = &queuePtr->buckets[key % queuePtr->numBucket];
+    if (bucketPtr->size == bucketPtr->capacity) {
+        long newCapacity = bucketPtr->capacity * BUCKET_GROWTH_FACTOR;
+        void** newElements = (void**)realloc(bucketPtr->elements,
+                                             newCapacity * sizeof(void*));
+        if (newElements == NULL) {
+            return FALSE;
+        }
+        bucketPtr->elements = newElements;
+        bucketPtr->capacity = newCapacity;
+    }
+
+    bucketPtr->elements[bucketPtr->size++] = dataPtr;
+    queuePtr->size++;
+
+    return TRUE;
+}
+
+
+/* =============================================================================
+ * bucketqueue_getMinKey
+ * -- Smallest key of any entry; the queue must not be empty
+ * =============================================================================
+ */
+long
+bucketqueue_getMinKey (bucketqueue_t* queuePtr)
+{
+    assert(queuePtr->size > 0);
+
+    long numBucket = queuePtr->numBucket;
+    long minKey = queuePtr->minKey;
+    while (queuePtr->buckets[minKey % numBucket].size == 0) {
+        minKey++;
+    }
+    queuePtr->minKey = minKey;
+
+    return minKey;
+}
+
+
+/* =============================================================================
+ * bucketqueue_remove
+ * -- Removes an entry with the smallest key and stores that key in *keyPtr
+ * -- Returns NULL if empty
+ * =============================================================================
+ */
+void*
+bucketqueue_remove (bucketqueue_t* queuePtr, long* keyPtr)
+{
+    if (queuePtr->size == 0) {
+        return NULL;
+    }
+
+    long minKey = bucketqueue_getMinKey(queuePtr);
+    bucket_t* bucketPtr = &queuePtr->buckets[minKey % queuePtr->numBucket];
+    queuePtr->size--;
+
+    if (keyPtr) {
+        *keyPtr = minKey;
+    }
+
+    return bucketPtr->elements[--(bucketPtr->size)];
+}
+
+
+/* =============================================================================
+ * TEST_BUCKETQUEUE
+ * =============================================================================
+ */
+#ifdef TEST_BUCKETQUEUE
+
+
+#include <stdio.h>
+
+
+int
+main ()
+{
+    bucketqueue_t* queuePtr;
+    long data[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    long numData = sizeof(data) / sizeof(data[0]);
+
+    puts("Starting tests...");
+
+    queuePtr = bucketqueue_alloc(2);
+    assert(queuePtr);
+    bucketqueue_clear(queuePtr, 0);
+    assert(bucketqueue_isEmpty(queuePtr));
+
+    /* Like a Dijkstra sweep: each removed key k inserts k+1 and k+2 */
+    assert(bucketqueue_insert(queuePtr, 0, &data[0]));
+    long prevKey = 0;
+    while (!bucketqueue_isEmpty(queuePtr)) {
+        long key;
+        long* dataPtr = (long*)bucketqueue_remove(queuePtr, &key);
+        printf("Removing %li\n", key);
+        assert(*dataPtr == key);
+        assert(key >= prevKey);
+        prevKey = key;
+        if (key + 2 < numData) {
+            assert(bucketqueue_insert(queuePtr, key + 2, &data[key + 2]));
+            assert(bucketqueue_insert(queuePtr, key + 1, &data[key + 1]));
+        }
+    }
+    assert(prevKey == numData - 1);
+    assert(bucketqueue_remove(queuePtr, NULL) == NULL);
+
+    bucketqueue_free(queuePtr);
+
+    puts("All tests passed.");
+
+    return 0;
+}
+
+
+#endif /* TEST_BUCKETQUEUE */
+
+
+/* =============================================================================
+ *
+ * End of bucketqueue.c
+ *
+ * =============================================================================
+ */
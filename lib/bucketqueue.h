@@ -0,0 +1,165 @@
+/* =============================================================================
+ *
+ * bucketqueue.h
+ * -- Monotone bucket priority queue (Dial) for small non-negative integer keys
+ * -- Every inserted key must lie in [min, min + maxStep], where min is the key
+ *    of the last entry removed
+ *
+ * =============================================================================
+ *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * Unless otherwise noted, the following license applies to STAMP files:
+ * 
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ * 
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ * 
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#ifndef BUCKETQUEUE_H
+#define BUCKETQUEUE_H 1
+
+#include "types.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct bucketqueue bucketqueue_t;
+
+
+/* =============================================================================
+ * bucketqueue_alloc
+ * -- 'maxStep' is the largest amount a key may exceed the current minimum by
+ * -- Returns NULL on failure
+ * =============================================================================
+ */
+bucketqueue_t*
+bucketqueue_alloc (long maxStep);
+
+
+/* =============================================================================
+ * bucketqueue_free
+ * =============================================================================
+ */
+void
+bucketqueue_free (bucketqueue_t* queuePtr);
+
+
+/* =============================================================================
+ * bucketqueue_isEmpty
+ * =============================================================================
+ */
+bool_t
+bucketqueue_isEmpty (bucketqueue_t* queuePtr);
+
+
+/* =============================================================================
+ * bucketqueue_clear
+ * -- Empties the queue and restarts the minimum at 'minKey'
+ * =============================================================================
+ */
+void
+bucketqueue_clear (bucketqueue_t* queuePtr, long minKey);
+
+
+/* =============================================================================
+ * bucketqueue_insert
+ * -- Returns FALSE on failure
+ * =============================================================================
+ */
+bool_t
+bucketqueue_insert (bucketqueue_t* queuePtr, long key, void* dataPtr);
+
+
+/* =============================================================================
+ * bucketqueue_getMinKey
+ * -- Smallest key of any entry; the queue must not be empty
+ * =============================================================================
+ */
+long
+bucketqueue_getMinKey (bucketqueue_t* queuePtr);
+
+
+/* =============================================================================
+ * bucketqueue_remove
+ * -- Removes an entry with the smallest key and stores that key in *keyPtr
+ * -- Returns NULL if empty
+ * =============================================================================
+ */
+void*
+bucketqueue_remove (bucketqueue_t* queuePtr, long* keyPtr);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* BUCKETQUEUE_H */
+
+
+/* =============================================================================
+ *
+ * End of bucketqueue.h
+ *
+ * =============================================================================
+ */
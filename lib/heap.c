@@ -0,0 +1,298 @@
+/* =============================================================================
+ *
+ * heap.c
+ * -- Binary min-heap of (key, data) entries, smallest key removed first
+ *
+ * =============================================================================
+ *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * Unless otherwise noted, the following license applies to STAMP files:
+ * 
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ * 
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ * 
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include "heap.h"
+#include "types.h"
+
+
+typedef struct heap_entry {
+    long key;
+    void* dataPtr;
+} heap_entry_t;
+
+struct heap {
+    heap_entry_t* elements; /* elements[0] is unused so children are 2i, 2i+1 */
+    long size;
+    long capacity;
+};
+
+enum config {
+    HEAP_GROWTH_FACTOR = 2,
+};
+
+
+/* =============================================================================
+ * heap_alloc
+ * -- Returns NULL on failure
+ * =============================================================================
+ */
+heap_t*
+heap_alloc (long initCapacity)
+{
+    heap_t* heapPtr = (heap_t*)malloc(sizeof(heap_t));
+
+    if (heapPtr) {
+        long capacity = ((initCapacity < 1) ? 1 : initCapacity);
+        heapPtr->elements = (heap_entry_t*)malloc((capacity + 1) * sizeof(heap_entry_t));
+        if (heapPtr->elements == NULL) {
+            free(heapPtr);
+            return NULL;
+        }
+        heapPtr->size     = 0;
+        heapPtr->capacity = capacity;
+    }
+
+    return heapPtr;
+}
+
+
+/* =============================================================================
+ * heap_free
+ * =============================================================================
+ */
+void
+heap_free (heap_t* heapPtr)
+{
+    free(heapPtr->elements);
+    free(heapPtr);
+}
+
+
+/* =============================================================================
+ * heap_isEmpty
+ * =============================================================================
+ */
+bool_t
+heap_isEmpty (heap_t* heapPtr)
+{
+    return ((heapPtr->size == 0) ? TRUE : FALSE);
+}
+
+
+/* =============================================================================
+ * heap_getSize
+ * =============================================================================
+ */
+long
+heap_getSize (heap_t* heapPtr)
+{
+    return heapPtr->size;
+}
+
+
+/* =============================================================================
+ * heap_clear
+ * =============================================================================
+ */
+void
+heap_clear (heap_t* heapPtr)
+{
+    heapPtr->size = 0;
+}
+
+
+/* =============================================================================
+ * heap_insert
+ * -- Returns FALSE on failure
+ * =============================================================================
+ */
+bool_t
+heap_insert (heap_t* heapPtr, long key, void* dataPtr)
+{
+    if (heapPtr->size == heapPtr->capacity) {
+        long newCapacity = heapPtr->capacity * HEAP_GROWTH_FACTOR;
+        heap_entry_t* newElements =
+            (heap_entry_t*)realloc(heapPtr->elements,
+                                   (newCapacity + 1) * sizeof(heap_entry_t));
+        if (newElements == NULL) {
+            return FALSE;
+        }
+        heapPtr->elements = newElements;
+        heapPtr->capacity = newCapacity;
+    }
+
+    /* Sift up */
+    heap_entry_t* elements = heapPtr->elements;
+    long i = ++(heapPtr->size);
+    while (i > 1 && elements[i / 2].key > key) {
+        elements[i] = elements[i / 2];
+        i /= 2;
+    }
+    elements[i].key = key;
+    elements[i].dataPtr = dataPtr;
+
+    return TRUE;
+}
+
+
+/* =============================================================================
+ * heap_remove
+ * -- Removes the entry with the smallest key and stores that key in *keyPtr
+ * -- Returns NULL if empty
+ * =============================================================================
+ */
+void*
+heap_remove (heap_t* heapPtr, long* keyPtr)
+{
+    long size = heapPtr->size;
+    if (size == 0) {
+        return NULL;
+    }
+
+    heap_entry_t* elements = heapPtr->elements;
+    void* dataPtr = elements[1].dataPtr;
+    if (keyPtr) {
+        *keyPtr = elements[1].key;
+    }
+
+    /* Sift down the last entry from the root */
+    heap_entry_t last = elements[size--];
+    long i = 1;
+    while (2 * i <= size) {
+        long child = 2 * i;
+        if (child < size && elements[child + 1].key < elements[child].key) {
+            child++;
+        }
+        if (last.key <= elements[child].key) {
+            break;
+        }
+        elements[i] = elements[child];
+        i = child;
+    }
+    elements[i] = last;
+    heapPtr->size = size;
+
+    return dataPtr;
+}
+
+
+/* =============================================================================
+ * TEST_HEAP
+ * =============================================================================
+ */
+#ifdef TEST_HEAP
+
+
+#include <stdio.h>
+
+
+int
+main ()
+{
+    heap_t* heapPtr;
+    long data[] = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+    long numData = sizeof(data) / sizeof(data[0]);
+    long i;
+
+    puts("Starting tests...");
+
+    heapPtr = heap_alloc(-1);
+    assert(heapPtr);
+    assert(heap_isEmpty(heapPtr));
+
+    for (i = 0; i < numData; i++) {
+        printf("Inserting %li\n", data[i]);
+        assert(heap_insert(heapPtr, data[i], &data[i]));
+    }
+    assert(heap_getSize(heapPtr) == numData);
+
+    long prevKey = -1;
+    for (i = 0; i < numData; i++) {
+        long key;
+        long* dataPtr = (long*)heap_remove(heapPtr, &key);
+        printf("Removing %li\n", key);
+        assert(*dataPtr == key);
+        assert(key >= prevKey);
+        prevKey = key;
+    }
+    assert(heap_remove(heapPtr, NULL) == NULL);
+    assert(heap_isEmpty(heapPtr));
+
+    heap_free(heapPtr);
+
+    puts("All tests passed.");
+
+    return 0;
+}
+
+
+#endif /* TEST_HEAP */
+
+
+/* =============================================================================
+ *
+ * End of heap.c
+ *
+ * =============================================================================
+ */
@@ -0,0 +1,207 @@
+/* =============================================================================
+ *
+ * ringqueue.h
+ * -- Typed FIFO over a power-of-two ring, generated per element type
+ *
+ * =============================================================================
+ *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * Unless otherwise noted, the following license applies to STAMP files:
+ * 
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ * 
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ * 
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#ifndef RINGQUEUE_H
+#define RINGQUEUE_H 1
+
+#include <assert.h>
+#include <stdlib.h>
+#include "types.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =============================================================================
+ * RINGQUEUE_DEFINE
+ * -- Declares NAME_t, a FIFO of TYPE values, and static inline NAME_alloc,
+ *    NAME_free, NAME_reserve, NAME_clear, NAME_isEmpty, NAME_push and NAME_pop
+ * -- The capacity is a power of two and the pop and push counts only ever
+ *    grow, so slots are found with a mask instead of '%' and a full ring needs
+ *    no spare slot. Pushing into a full ring doubles it; NAME_reserve grows
+ *    it up front so the hot path never has to.
+ * =============================================================================
+ */
+#define RINGQUEUE_DEFINE(NAME, TYPE)                                            \
+                                                                                \
+typedef struct NAME {                                                           \
+    unsigned long pop;  /* elements popped so far */                            \
+    unsigned long push; /* elements pushed so far */                            \
+    unsigned long mask; /* capacity - 1 */                                      \
+    TYPE* elements;                                                             \
+} NAME##_t;                                                                     \
+                                                                                \
+static inline bool_t                                                            \
+NAME##_reserve (NAME##_t* queuePtr, long minCapacity)                           \
+{                                                                               \
+    unsigned long capacity = queuePtr->mask + 1;                                \
+    if ((unsigned long)minCapacity <= capacity) {                               \
+        return TRUE;                                                            \
+    }                                                                           \
+    while (capacity < (unsigned long)minCapacity) {                             \
+        capacity *= 2;                                                          \
+    }                                                                           \
+    TYPE* newElements = (TYPE*)malloc(capacity * sizeof(TYPE));                 \
+    if (newElements == NULL) {                                                  \
+        return FALSE;                                                           \
+    }                                                                           \
+    /* Unwrap the live elements to the front of the new ring */                 \
+    unsigned long size = queuePtr->push - queuePtr->pop;                        \
+    unsigned long i;                                                            \
+    for (i = 0; i < size; i++) {                                                \
+        newElements[i] = queuePtr->elements[(queuePtr->pop + i) & queuePtr->mask]; \
+    }                                                                           \
+    free(queuePtr->elements);                                                   \
+    queuePtr->elements = newElements;                                           \
+    queuePtr->mask = capacity - 1;                                              \
+    queuePtr->pop  = 0;                                                         \
+    queuePtr->push = size;                                                      \
+    return TRUE;                                                                \
+}                                                                               \
+                                                                                \
+static inline NAME##_t*                                                         \
+NAME##_alloc (long initCapacity)                                                \
+{                                                                               \
+    NAME##_t* queuePtr = (NAME##_t*)malloc(sizeof(NAME##_t));                   \
+    if (queuePtr) {                                                             \
+        queuePtr->pop = 0;                                                      \
+        queuePtr->push = 0;                                                     \
+        queuePtr->mask = 0;                                                     \
+        queuePtr->elements = (TYPE*)malloc(sizeof(TYPE));                       \
+        if (queuePtr->elements == NULL ||                                       \
+            !NAME##_reserve(queuePtr, initCapacity))                            \
+        {                                                                       \
+            free(queuePtr->elements);                                           \
+            free(queuePtr);                                                     \
+            return NULL;                                                        \
+        }                                                                       \
+    }                                                                           \
+    return queuePtr;                                                            \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+NAME##_free (NAME##_t* queuePtr)                                                \
+{                                                                               \
+    free(queuePtr->elements);                                                   \
+    free(queuePtr);                                                             \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+NAME##_clear (NAME##_t* queuePtr)                                               \
+{                                                                               \
+    queuePtr->pop  = 0;                                                         \
+    queuePtr->push = 0;                                                         \
+}                                                                               \
+                                                                                \
+static inline bool_t                                                            \
+NAME##_isEmpty (NAME##_t* queuePtr)                                             \
+{                                                                               \
+    return ((queuePtr->pop == queuePtr->push) ? TRUE : FALSE);                  \
+}                                                                               \
+                                                                                \
+static inline bool_t                                                            \
+NAME##_push (NAME##_t* queuePtr, TYPE data)                                     \
+{                                                                               \
+    if (__builtin_expect((queuePtr->push - queuePtr->pop) > queuePtr->mask, 0)) { \
+        if (!NAME##_reserve(queuePtr, (long)(2 * (queuePtr->mask + 1)))) {      \
+            return FALSE;                                                       \
+        }                                                                       \
+    }                                                                           \
+    queuePtr->elements[queuePtr->push++ & queuePtr->mask] = data;               \
+    return TRUE;                                                                \
+}                                                                               \
+                                                                                \
+/* Callers check NAME_isEmpty first: a TYPE has no spare value for "none" */   \
+static inline TYPE                                                              \
+NAME##_pop (NAME##_t* queuePtr)                                                 \
+{                                                                               \
+    assert(queuePtr->pop != queuePtr->push);                                    \
+    return queuePtr->elements[queuePtr->pop++ & queuePtr->mask];                \
+}
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* RINGQUEUE_H */
+
+
+/* =============================================================================
+ *
+ * End of ringqueue.h
+ *
+ * =============================================================================
+ */
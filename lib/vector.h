@@ -73,6 +73,8 @@
 #define VECTOR_H 1
 
 
+#include <stdlib.h>
+#include <string.h>
 #include "types.h"
 
 
@@ -88,6 +90,106 @@ typedef struct vector {
 } vector_t;
 
 
+/* =============================================================================
+ * VECTOR_DEFINE_TYPED
+ * -- Declares NAME_t, a vector of TYPE values with room for NUM_INLINE of
+ *    them inside the object itself, and static inline NAME_alloc, NAME_free,
+ *    NAME_reserve, NAME_clear, NAME_getSize, NAME_at and NAME_pushBack
+ * -- Elements live in the inline buffer until they outgrow it, so a vector
+ *    that is reserved up front from a known or estimated size costs one
+ *    allocation, or none beyond the object when the estimate fits inline
+ * -- Elements move when the vector grows: hold indices, not pointers, until
+ *    it is complete
+ * =============================================================================
+ */
+#define VECTOR_DEFINE_TYPED(NAME, TYPE, NUM_INLINE)                             \
+                                                                                \
+typedef struct NAME {                                                           \
+    long size;                                                                  \
+    long capacity;                                                              \
+    TYPE* elements; /* 'buffer' until the first growth */                       \
+    TYPE buffer[NUM_INLINE];                                                    \
+} NAME##_t;                                                                     \
+                                                                                \
+static inline bool_t                                                            \
+NAME##_reserve (NAME##_t* vectorPtr, long minCapacity)                          \
+{                                                                               \
+    if (minCapacity <= vectorPtr->capacity) {                                   \
+        return TRUE;                                                            \
+    }                                                                           \
+    long newCapacity = vectorPtr->capacity * 2;                                 \
+    if (newCapacity < minCapacity) {                                            \
+        newCapacity = minCapacity;                                              \
+    }                                                                           \
+    TYPE* newElements = (TYPE*)malloc(newCapacity * sizeof(TYPE));              \
+    if (newElements == NULL) {                                                  \
+        return FALSE;                                                           \
+    }                                                                           \
+    memcpy(newElements, vectorPtr->elements, vectorPtr->size * sizeof(TYPE));   \
+    if (vectorPtr->elements != vectorPtr->buffer) {                             \
+        free(vectorPtr->elements);                                              \
+    }                                                                           \
+    vectorPtr->elements = newElements;                                          \
+    vectorPtr->capacity = newCapacity;                                          \
+    return TRUE;                                                                \
+}                                                                               \
+                                                                                \
+static inline NAME##_t*                                                         \
+NAME##_alloc (long initCapacity)                                                \
+{                                                                               \
+    NAME##_t* vectorPtr = (NAME##_t*)malloc(sizeof(NAME##_t));                  \
+    if (vectorPtr) {                                                            \
+        vectorPtr->size = 0;                                                    \
+        vectorPtr->capacity = NUM_INLINE;                                       \
+        vectorPtr->elements = vectorPtr->buffer;                                \
+        if (!NAME##_reserve(vectorPtr, initCapacity)) {                         \
+            free(vectorPtr);                                                    \
+            return NULL;                                                        \
+        }                                                                       \
+    }                                                                           \
+    return vectorPtr;                                                           \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+NAME##_free (NAME##_t* vectorPtr)                                               \
+{                                                                               \
+    if (vectorPtr->elements != vectorPtr->buffer) {                             \
+        free(vectorPtr->elements);                                              \
+    }                                                                           \
+    free(vectorPtr);                                                            \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+NAME##_clear (NAME##_t* vectorPtr)                                              \
+{                                                                               \
+    vectorPtr->size = 0;                                                        \
+}                                                                               \
+                                                                                \
+static inline long                                                              \
+NAME##_getSize (NAME##_t* vectorPtr)                                            \
+{                                                                               \
+    return vectorPtr->size;                                                     \
+}                                                                               \
+                                                                                \
+static inline TYPE*                                                             \
+NAME##_at (NAME##_t* vectorPtr, long i)                                         \
+{                                                                               \
+    return &vectorPtr->elements[i];                                             \
+}                                                                               \
+                                                                                \
+static inline bool_t                                                            \
+NAME##_pushBack (NAME##_t* vectorPtr, TYPE data)                                \
+{                                                                               \
+    if (__builtin_expect(vectorPtr->size == vectorPtr->capacity, 0)) {          \
+        if (!NAME##_reserve(vectorPtr, vectorPtr->size + 1)) {                  \
+            return FALSE;                                                       \
+        }                                                                       \
+    }                                                                           \
+    vectorPtr->elements[vectorPtr->size++] = data;                              \
+    return TRUE;                                                                \
+}
+
+
 /* =============================================================================
  * vector_alloc
  * -- Returns NULL if failed